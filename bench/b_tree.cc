@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include "../src/b_tree.hpp"
+#include "../src/rb_tree.hpp"
+#include "../src/vector.hpp"
+
+// The keys 0, 2, 4, ... in a random order.
+static vector<int> shuffled(int64_t n, uint64_t& state) {
+    vector<int> keys;
+
+    for (int64_t k = 0; k < n; k++) keys.push_back(static_cast<int>(2*k));
+
+    for (int64_t k = n - 1; k > 0; k--) {
+        int64_t j = static_cast<int64_t>(xorshift(state) % static_cast<uint64_t>(k + 1));
+        int t = keys[k];
+
+        keys[k] = keys[j];
+        keys[j] = t;
+    }
+
+    return keys;
+}
+
+template <typename Tree> void measure(const char* name, int64_t n) {
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+    vector<int> inserts = shuffled(n, state),
+                erases = shuffled(n, state);
+    int64_t found = 0;
+    Tree tree;
+    char label[64];
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < n; k++) tree.insert(inserts[k]);
+    });
+
+    snprintf(label, sizeof(label), "%s insert", name);
+    report(label, n, n, seconds);
+
+    // Odd keys miss, so about half the lookups fail.
+    seconds = time_it([&]() {
+        for (int64_t k = 0; k < n; k++) found += (tree.search(static_cast<int>(xorshift(state) % (2*n))) != nullptr);
+    });
+
+    do_not_optimize(found);
+    snprintf(label, sizeof(label), "%s lookup", name);
+    report(label, n, n, seconds);
+
+    // Every key, in a different order from the inserts.
+    seconds = time_it([&]() {
+        for (int64_t k = 0; k < n; k++) tree.remove(erases[k]);
+    });
+
+    snprintf(label, sizeof(label), "%s erase", name);
+    report(label, n, n, seconds);
+}
+
+// 10^8 keys take about 4 GB in rb_tree nodes; raise the bound on a
+// machine with room for them.
+int main() {
+    for (int64_t n = 10000; n <= 10000000; n *= 10) {
+        measure<rb_tree<int>>("rb_tree", n);
+        measure<b_tree<int>>("b_tree", n);
+    }
+}
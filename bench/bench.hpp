@@ -0,0 +1,36 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#pragma once
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+// Runs fn once and returns the elapsed wall time in seconds.
+template <typename F> inline double time_it(F fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+// Small, fast PRNG so the generator does not dominate the timings.
+inline uint64_t xorshift(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+inline void report(const char* name, int64_t n, int64_t ops, double seconds) {
+    printf("%-28s n=%-10lld %12.4f Mops/s %10.3f s\n", name, (long long) n,
+           ops / seconds / 1e6, seconds);
+}
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T> inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include "bench.hpp"
+#include "../src/map.hpp"
+#include "../src/set.hpp"
+#include <new>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Every allocation in the process goes through here, so the benchmark
+// can report how many each phase performed.
+static int64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+// Resident set size in MiB.
+static double rss() {
+    long pages = 0, resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+
+    if (statm == nullptr) return 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+
+    return resident * (double) sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+// A set kept at about n keys while keys are inserted and removed at
+// random, so every phase ends with the same contents; the RSS should
+// level off after the first phase.
+template <typename S> void churn(const char* name, int64_t n, int64_t phases) {
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+    S s;
+
+    for (int64_t p = 0; p < phases; p++) {
+        int64_t before = allocations;
+
+        double seconds = time_it([&]() {
+            for (int64_t k = 0; k < n; k++) {
+                s.insert(static_cast<int>(xorshift(state) % (2*n)));
+                s.remove(static_cast<int>(xorshift(state) % (2*n)));
+            }
+        });
+
+        report(name, n, 2*n, seconds);
+        printf("%-28s %lld allocations, %.1f MiB resident\n", "",
+               (long long) (allocations - before), rss());
+    }
+}
+
+int main() {
+    const int64_t n = 1000000;
+
+    churn<set<int>>("set<int> insert/remove", n, 5);
+
+    // Every insert is of a value already present.
+    set<int> s;
+
+    for (int64_t k = 0; k < n; k++) s.insert(static_cast<int>(k));
+
+    int64_t before = allocations;
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < n; k++) s.insert(static_cast<int>(k));
+    });
+
+    report("set<int> duplicate insert", n, n, seconds);
+    printf("%-28s %lld allocations\n", "", (long long) (allocations - before));
+
+    map<int,int> m;
+
+    for (int64_t k = 0; k < n; k++) m.insert(static_cast<int>(k), 0);
+
+    before = allocations;
+    seconds = time_it([&]() {
+        for (int64_t k = 0; k < n; k++) m.insert(static_cast<int>(k), 1);
+    });
+
+    report("map<int,int> overwrite", n, n, seconds);
+    printf("%-28s %lld allocations\n", "", (long long) (allocations - before));
+}
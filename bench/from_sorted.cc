@@ -0,0 +1,47 @@
+#include "bench.hpp"
+#include "../src/b_tree.hpp"
+#include "../src/set.hpp"
+#include "../src/vector.hpp"
+
+// Loading n sorted keys one insert at a time against from_sorted, and
+// copying the result.
+template <typename S> void measure(const char* name, const vector<int>& keys) {
+    int64_t n = keys.size();
+    char label[64];
+
+    S inserted;
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < n; k++) inserted.insert(keys[k]);
+    });
+
+    snprintf(label, sizeof(label), "%s insert", name);
+    report(label, n, n, seconds);
+
+    S built;
+
+    seconds = time_it([&]() { built = S::from_sorted(keys); });
+
+    snprintf(label, sizeof(label), "%s from_sorted", name);
+    report(label, n, n, seconds);
+
+    S copy;
+
+    seconds = time_it([&]() { copy = built; });
+
+    snprintf(label, sizeof(label), "%s copy", name);
+    report(label, n, n, seconds);
+
+    do_not_optimize(inserted.size() + built.size() + copy.size());
+}
+
+int main() {
+    for (int64_t n = 100000; n <= 10000000; n *= 10) {
+        vector<int> keys;
+
+        for (int64_t k = 0; k < n; k++) keys.push_back(static_cast<int>(3*k));
+
+        measure<set<int>>("set<int>", keys);
+        measure<set<int, b_tree<int>>>("set<int, b_tree>", keys);
+    }
+}
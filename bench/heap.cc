@@ -0,0 +1,132 @@
+#include "bench.hpp"
+#include "../src/d_ary_heap.hpp"
+#include "../src/heap.hpp"
+#include "../src/pairing_heap.hpp"
+#include "../src/tree_node.hpp"
+
+// The previous max_heap: one tree_node per element, with every insert and
+// pop locating its slot by building a dec_to_bin path and walking it from
+// the root. Reproduced here (with its sift bugs fixed) as the baseline.
+template <typename T> class pointer_heap {
+    private:
+        int64_t heap_size = 0;
+        tree_node<T>* heap_root = nullptr;
+
+        tree_node<T>* navigate(list<bool> navigation) const {
+            tree_node<T>* current = this->heap_root;
+            navigation.pop_front();
+
+            while (!navigation.is_empty()) {
+                current = (navigation.pop_front() ? current->right() : current->left());
+            }
+
+            return current;
+        }
+    public:
+        void insert(T value) {
+            tree_node<T>* node = new tree_node<T>(value);
+
+            if (++this->heap_size == 1) {
+                this->heap_root = node;
+                return;
+            }
+
+            list<bool> navigation = dec_to_bin(this->heap_size);
+            bool R = navigation.pop_back();
+            tree_node<T>* parent = this->navigate(navigation);
+
+            if (R) parent->right(node);
+            else parent->left(node);
+
+            while (node->parent() != nullptr && node->value() > node->parent()->value()) {
+                swap(node, node->parent());
+                node = node->parent();
+            }
+        }
+
+        T pop() {
+            T value = this->heap_root->value();
+            tree_node<T>* last = this->navigate(dec_to_bin(this->heap_size--));
+
+            swap(this->heap_root, last);
+
+            if (last->parent() != nullptr) {
+                if (last->is_right_node()) last->parent()->right(nullptr);
+                else last->parent()->left(nullptr);
+            } else {
+                this->heap_root = nullptr;
+            }
+
+            delete last;
+
+            tree_node<T>* current = this->heap_root;
+
+            while (current != nullptr) {
+                tree_node<T>* child = current->left();
+
+                if (child == nullptr) break;
+                if (current->right() != nullptr && current->right()->value() > child->value())
+                    child = current->right();
+                if (!(child->value() > current->value())) break;
+
+                swap(current, child);
+                current = child;
+            }
+
+            return value;
+        }
+};
+
+template <typename H> void push_pop_cycle(const char* name, int64_t n) {
+    H heap;
+    uint64_t state = 88172645463325252ull;
+    int64_t checksum = 0;
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < n; k++) heap.insert(static_cast<int64_t>(xorshift(state) >> 32));
+        for (int64_t k = 0; k < n; k++) checksum += heap.pop();
+    });
+
+    do_not_optimize(checksum);
+    report(name, n, 2*n, seconds);
+}
+
+// Folds 64 shards of n/64 elements each into the first one.
+template <typename H> void meld_cycle(const char* name, int64_t n) {
+    const int64_t shards = 64;
+    H* heaps = new H[shards];
+    uint64_t state = 88172645463325252ull;
+
+    for (int64_t k = 0; k < n; k++) heaps[k % shards].insert(static_cast<int64_t>(xorshift(state) >> 32));
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 1; k < shards; k++) heaps[0].merge(static_cast<H&&>(heaps[k]));
+    });
+
+    do_not_optimize(heaps[0].root());
+    report(name, n, shards-1, seconds);
+
+    delete[] heaps;
+}
+
+int main() {
+    for (int64_t n = 1000; n <= 10000000; n *= 10) {
+        push_pop_cycle<max_heap<int64_t>>("max_heap (array)", n);
+        push_pop_cycle<d_ary_max_heap<int64_t, 4>>("d_ary_heap<4>", n);
+        push_pop_cycle<d_ary_max_heap<int64_t, 8>>("d_ary_heap<8>", n);
+        push_pop_cycle<d_ary_min_heap<int64_t, 8>>("d_ary_heap<8> (min)", n);
+        push_pop_cycle<pairing_max_heap<int64_t>>("pairing_heap", n);
+
+        // The pointer heap allocates O(log n) list nodes per operation
+        // and takes minutes at 10^7, so the baseline stops at 10^6.
+        if (n <= 1000000)
+            push_pop_cycle<pointer_heap<int64_t>>("max_heap (tree_node)", n);
+    }
+
+    printf("\nmeld 64 shards (Mops = melds)\n");
+
+    for (int64_t n = 1000; n <= 10000000; n *= 10) {
+        meld_cycle<max_heap<int64_t>>("max_heap::merge", n);
+        meld_cycle<pairing_max_heap<int64_t>>("pairing_heap::meld", n);
+    }
+}
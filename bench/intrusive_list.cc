@@ -0,0 +1,121 @@
+#include "bench.hpp"
+#include "../src/intrusive_list.hpp"
+#include "../src/list.hpp"
+#include "../src/vector.hpp"
+#include <new>
+#include <stdlib.h>
+
+// Counts every allocation so the phases can show they perform none.
+static int64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+// Stand-in for a connection object that already lives in an arena.
+struct connection : list_hook<connection> {
+    int64_t id;
+    char buffer[64];
+};
+
+int main() {
+    const int64_t ops = 10000000;
+
+    for (int64_t n = 1000; n <= 1000000; n *= 10) {
+        vector<connection> arena;
+        arena.resize(n);
+
+        for (int64_t k = 0; k < n; k++) arena[k].id = k;
+
+        // FIFO wait queue: list<connection> copies each object into a
+        // node, intrusive_list links the arena object itself.
+        {
+            list<connection> q;
+            int64_t checksum = 0;
+
+            for (int64_t k = 0; k < n/2; k++) q.push_back(arena[k]);
+
+            int64_t before = allocations;
+
+            double seconds = time_it([&]() {
+                for (int64_t k = 0; k < ops; k++) {
+                    q.push_back(arena[(n/2 + k) % n]);
+                    checksum += q.pop_front().id;
+                }
+            });
+
+            do_not_optimize(checksum);
+            report("list<connection> queue", n, 2*ops, seconds);
+            printf("%-28s %lld allocations\n", "", (long long) (allocations - before));
+        }
+
+        {
+            intrusive_list<connection> q;
+            int64_t checksum = 0;
+
+            for (int64_t k = 0; k < n/2; k++) q.push_back(&arena[k]);
+
+            int64_t before = allocations;
+
+            double seconds = time_it([&]() {
+                for (int64_t k = 0; k < ops; k++) {
+                    q.push_back(&arena[(n/2 + k) % n]);
+                    checksum += q.pop_front()->id;
+                }
+            });
+
+            do_not_optimize(checksum);
+            report("intrusive_list queue", n, 2*ops, seconds);
+            printf("%-28s %lld allocations\n", "", (long long) (allocations - before));
+        }
+
+        // LRU: every access moves a random object to the front and the
+        // back is the eviction candidate. list can only unlink by value.
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+
+        if (n <= 10000) {
+            list<int64_t*> lru;
+            int64_t checksum = 0;
+            int64_t lru_ops = ops / n;
+
+            for (int64_t k = 0; k < n; k++) lru.push_back(&arena[k].id);
+
+            double seconds = time_it([&]() {
+                for (int64_t k = 0; k < lru_ops; k++) {
+                    int64_t* touched = &arena[xorshift(state) % n].id;
+                    lru.remove(touched);
+                    lru.push_front(touched);
+                    checksum += *lru.back()->value();
+                }
+            });
+
+            do_not_optimize(checksum);
+            report("list LRU touch", n, lru_ops, seconds);
+        }
+
+        {
+            intrusive_list<connection> lru;
+            int64_t checksum = 0;
+
+            for (int64_t k = 0; k < n; k++) lru.push_back(&arena[k]);
+
+            int64_t before = allocations;
+
+            double seconds = time_it([&]() {
+                for (int64_t k = 0; k < ops; k++) {
+                    lru.move_to_front(&arena[xorshift(state) % n]);
+                    checksum += lru.back()->id;
+                }
+            });
+
+            do_not_optimize(checksum);
+            report("intrusive_list LRU touch", n, ops, seconds);
+            printf("%-28s %lld allocations\n", "", (long long) (allocations - before));
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#include "bench.hpp"
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/rb_tree.hpp"
+#include <new>
+#include <stdlib.h>
+
+static int64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+// The queue deque used to be: a list with a node per element.
+template <typename T> class list_queue : public list<T> {};
+
+// level_order_traversal with the queue type as a parameter.
+template <typename Q, typename T> list<T> level_order(const rb_tree<T>& tree) {
+    list<T> traversal;
+    Q q;
+
+    if (tree.root() != nullptr)
+        q.push_back(tree.root());
+
+    while (!q.is_empty()) {
+        rb_node<T>* node = q.pop_front();
+
+        traversal.push_back(node->value());
+
+        if (node->right() != nullptr)
+            q.push_back(node->right());
+        if (node->left() != nullptr)
+            q.push_back(node->left());
+    }
+
+    return traversal;
+}
+
+template <typename F> void measure(const char* name, int64_t n, int64_t rounds, F traverse) {
+    int64_t checksum = 0,
+            before = allocations;
+
+    double seconds = time_it([&]() {
+        for (int64_t r = 0; r < rounds; r++) checksum += traverse().size();
+    });
+
+    do_not_optimize(checksum);
+    report(name, n, n*rounds, seconds);
+    printf("%-28s %lld allocations per traversal\n", "",
+           (long long) ((allocations - before) / rounds));
+}
+
+int main() {
+    const int64_t n = 1000000, rounds = 10;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    rb_tree<int> tree;
+
+    for (int64_t k = 0; k < n; k++) tree.insert(static_cast<int>(xorshift(state) >> 33));
+
+    measure("level order, list queue", n, rounds, [&]() {
+        return level_order<list_queue<rb_node<int>*>>(tree);
+    });
+
+    measure("level order, ring deque", n, rounds, [&]() {
+        return level_order<deque<rb_node<int>*>>(tree);
+    });
+
+    measure("level_order_traversal", n, rounds, [&]() { return level_order_traversal(tree); });
+}
@@ -0,0 +1,68 @@
+#include "bench.hpp"
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include <new>
+#include <stdlib.h>
+
+// Every allocation in the process goes through here, so the benchmark
+// can report exactly how many a phase performed.
+static int64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+// Fills the container to `live` elements, then runs `ops` rounds of one
+// push and one pop, counting allocations made during the rounds only.
+template <typename L> void steady_state(const char* name, int64_t live, int64_t ops, bool fifo) {
+    L l;
+    int64_t checksum = 0;
+
+    for (int64_t k = 0; k < live; k++) l.push_back(static_cast<int>(k));
+
+    int64_t before = allocations;
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < ops; k++) {
+            l.push_back(static_cast<int>(k));
+            checksum += (fifo ? l.pop_front() : l.pop_back());
+        }
+    });
+
+    do_not_optimize(checksum);
+    report(name, live, 2*ops, seconds);
+    printf("%-28s %lld allocations in %lld push/pop rounds\n", "",
+           (long long) (allocations - before), (long long) ops);
+}
+
+// Fills and clears the same list repeatedly; the pool starts over each
+// time, so allocations are per slab rather than per node.
+void refill(int64_t n, int64_t rounds) {
+    list<int> l;
+    int64_t before = allocations;
+
+    double seconds = time_it([&]() {
+        for (int64_t r = 0; r < rounds; r++) {
+            for (int64_t k = 0; k < n; k++) l.push_back(static_cast<int>(k));
+            l.clear();
+        }
+    });
+
+    report("list fill + clear", n, n*rounds, seconds);
+    printf("%-28s %lld allocations for %lld nodes\n", "",
+           (long long) (allocations - before), (long long) (n*rounds));
+}
+
+int main() {
+    for (int64_t live = 1000; live <= 1000000; live *= 10) {
+        steady_state<list<int>>("list (queue)", live, 10000000, true);
+        steady_state<deque<int>>("deque", live, 10000000, true);
+    }
+
+    refill(1000000, 10);
+}
@@ -0,0 +1,41 @@
+#include "bench.hpp"
+#include "../src/list.hpp"
+#include <thread>
+
+// Sorts 10^6 values in three input orders, serially and with one run per
+// hardware thread (at least four, so the parallel path is exercised).
+void sort_rows(const char* order, int64_t n, uint64_t pattern) {
+    uint64_t state = 88172645463325252ull;
+    int64_t threads = std::thread::hardware_concurrency();
+
+    if (threads < 4) threads = 4;
+
+    for (int64_t parallel = 0; parallel < 2; parallel++) {
+        list<int> l;
+
+        for (int64_t k = 0; k < n; k++) {
+            int value = (pattern == 0 ? static_cast<int>(xorshift(state) >> 33) :
+                         pattern == 1 ? static_cast<int>(k) : static_cast<int>(n - k));
+            l.push_back(value);
+        }
+
+        double seconds = time_it([&]() {
+            if (parallel) l.parallel_sort(threads);
+            else l.sort();
+        });
+
+        char name[64];
+        snprintf(name, sizeof(name), "%s %s", order, parallel ? "(parallel)" : "(serial)");
+        report(name, n, n, seconds);
+    }
+}
+
+int main() {
+    printf("%lld hardware threads\n", (long long) std::thread::hardware_concurrency());
+
+    for (int64_t n = 10000; n <= 1000000; n *= 10) {
+        sort_rows("random", n, 0);
+        sort_rows("sorted", n, 1);
+        sort_rows("reversed", n, 2);
+    }
+}
@@ -0,0 +1,65 @@
+#include "bench.hpp"
+#include "../src/map.hpp"
+#include "../src/set.hpp"
+#include <malloc.h>
+#include <new>
+#include <stdlib.h>
+
+// Every allocation in the process goes through here, so the benchmark
+// can report the bytes a container asked for and the bytes malloc
+// actually handed out, which includes its rounding to chunk sizes.
+static int64_t requested = 0, usable = 0;
+
+void* operator new(std::size_t size) {
+    if (void* p = malloc(size)) {
+        requested += size;
+        usable += malloc_usable_size(p);
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Both deletes release through one out-of-line function. Inlined into a
+// delete expression, a bare free() is flagged by -Wmismatched-new-delete
+// against the operator new above, although both sides use malloc.
+__attribute__((noinline)) static void release(void* p) noexcept { free(p); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+
+template <typename F> void measure(const char* name, int64_t n, F build) {
+    int64_t r = requested, u = usable;
+
+    double seconds = time_it(build);
+
+    report(name, n, n, seconds);
+    printf("%-28s %.1f bytes requested, %.1f bytes used per element\n", "",
+           (double) (requested - r) / n, (double) (usable - u) / n);
+}
+
+int main() {
+    printf("sizeof(rb_node<int>)           = %zu\n", sizeof(rb_node<int>));
+    printf("sizeof(rb_node<pair<int,int>>) = %zu\n", sizeof(rb_node<pair<int,int>>));
+
+    for (int64_t n = 1000; n <= 1000000; n *= 10) {
+        // Distinct keys in a scrambled order: k * an odd constant mod a
+        // power of two is a permutation.
+        int64_t mask = 1;
+
+        while (mask < n) mask <<= 1;
+
+        set<int> s;
+        map<int,int> m;
+
+        measure("set<int>", n, [&]() {
+            for (int64_t k = 0; k < n; k++) s.insert(static_cast<int>((k * 0x9E3779B1ll) & (mask - 1)));
+        });
+
+        measure("map<int,int>", n, [&]() {
+            for (int64_t k = 0; k < n; k++) m.insert(static_cast<int>((k * 0x9E3779B1ll) & (mask - 1)), k);
+        });
+
+        do_not_optimize(s.root());
+        do_not_optimize(m.root());
+    }
+}
@@ -0,0 +1,91 @@
+#include "bench.hpp"
+#include "../src/deque.hpp"
+#include "../src/mpmc_queue.hpp"
+#include "../src/spsc_queue.hpp"
+#include "../src/MACROS.hpp"
+#include <mutex>
+#include <thread>
+
+// The baseline: a deque behind one lock, bounded like the lock-free queues.
+struct locked_deque {
+    std::mutex lock;
+    deque<int64_t> items;
+    int64_t bound;
+
+    locked_deque(int64_t bound) : bound(bound) {}
+
+    bool try_push(int64_t value) {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        if (this->items.size() == this->bound) return false;
+
+        this->items.push_back(value);
+        return true;
+    }
+
+    bool try_pop(int64_t& value) {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        if (this->items.is_empty()) return false;
+
+        value = this->items.pop_front();
+        return true;
+    }
+};
+
+// `threads` producers and as many consumers pass `items` values in total
+// through the queue; both sides yield when it is full or empty.
+template <typename Q> void contention(const char* name, Q& queue, int64_t threads, int64_t items) {
+    int64_t per_thread = items / threads;
+
+    double seconds = time_it([&]() {
+        std::thread* workers = new std::thread[2*threads];
+
+        for (int64_t t = 0; t < threads; t++) {
+            workers[t] = std::thread([&queue, t, per_thread]() {
+                for (int64_t k = 0; k < per_thread; k++) {
+                    while (!queue.try_push(t * per_thread + k)) std::this_thread::yield();
+                }
+            });
+
+            workers[threads + t] = std::thread([&queue, per_thread]() {
+                int64_t value, checksum = 0;
+
+                for (int64_t k = 0; k < per_thread; k++) {
+                    while (!queue.try_pop(value)) std::this_thread::yield();
+                    checksum += value;
+                }
+
+                do_not_optimize(checksum);
+            });
+        }
+
+        for (int64_t t = 0; t < 2*threads; t++) workers[t].join();
+
+        delete[] workers;
+    });
+
+    report(name, threads, 2 * threads * per_thread, seconds);
+}
+
+int main() {
+    const int64_t items = 4000000, capacity = 1024;
+    int64_t max_threads = MAX(static_cast<int64_t>(std::thread::hardware_concurrency()),
+                              static_cast<int64_t>(8));
+
+    printf("producer/consumer pairs on the n= column; %lld hardware threads\n",
+           (long long) std::thread::hardware_concurrency());
+
+    {
+        spsc_queue<int64_t> queue(capacity);
+        contention("spsc_queue", queue, 1, items);
+    }
+
+    for (int64_t threads = 1; threads <= max_threads; threads *= 2) {
+        locked_deque locked(capacity);
+        mpmc_queue<int64_t> lock_free(capacity);
+
+        contention("deque + mutex", locked, threads, items);
+        contention("mpmc_queue", lock_free, threads, items);
+    }
+}
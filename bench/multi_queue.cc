@@ -0,0 +1,75 @@
+#include "bench.hpp"
+#include "../src/heap.hpp"
+#include "../src/multi_queue.hpp"
+#include <mutex>
+#include <thread>
+
+// The baseline: every operation takes one global lock.
+struct locked_max_heap {
+    std::mutex lock;
+    max_heap<int64_t> heap;
+
+    void insert(int64_t value) {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->heap.insert(value);
+    }
+
+    bool try_pop(int64_t& value) {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        if (this->heap.is_empty()) return false;
+
+        value = this->heap.pop();
+        return true;
+    }
+};
+
+// Each thread alternates an insert and a pop on a queue that starts with
+// `prefill` elements, so its size stays roughly constant.
+template <typename Q> void scaling(const char* name, Q& queue, int64_t threads,
+                                   int64_t prefill, int64_t ops_per_thread) {
+    uint64_t seed = 88172645463325252ull;
+
+    for (int64_t k = 0; k < prefill; k++) queue.insert(static_cast<int64_t>(xorshift(seed) >> 32));
+
+    double seconds = time_it([&]() {
+        std::thread* workers = new std::thread[threads];
+
+        for (int64_t t = 0; t < threads; t++) {
+            workers[t] = std::thread([&queue, t, ops_per_thread]() {
+                uint64_t state = 0x2545F4914F6CDD1Dull * (t + 1);
+                int64_t value, checksum = 0;
+
+                for (int64_t k = 0; k < ops_per_thread; k++) {
+                    queue.insert(static_cast<int64_t>(xorshift(state) >> 32));
+                    if (queue.try_pop(value)) checksum += value;
+                }
+
+                do_not_optimize(checksum);
+            });
+        }
+
+        for (int64_t t = 0; t < threads; t++) workers[t].join();
+
+        delete[] workers;
+    });
+
+    report(name, threads, 2 * threads * ops_per_thread, seconds);
+}
+
+int main() {
+    const int64_t prefill = 1000000, ops = 1000000;
+    int64_t max_threads = MAX(static_cast<int64_t>(std::thread::hardware_concurrency()),
+                              static_cast<int64_t>(8));
+
+    printf("threads on the n= column; %lld hardware threads\n",
+           (long long) std::thread::hardware_concurrency());
+
+    for (int64_t threads = 1; threads <= max_threads; threads *= 2) {
+        locked_max_heap locked;
+        multi_queue<int64_t> relaxed(threads, 2);
+
+        scaling("max_heap + mutex", locked, threads, prefill, ops);
+        scaling("multi_queue (c = 2)", relaxed, threads, prefill, ops);
+    }
+}
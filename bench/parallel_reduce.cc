@@ -0,0 +1,60 @@
+#include "bench.hpp"
+#include "../src/parallel.hpp"
+#include "../src/vector.hpp"
+#include <thread>
+
+int main() {
+    const int64_t n = 10000000, tree_n = 1000000, rounds = 10;
+    int64_t max_threads = MAX(static_cast<int64_t>(std::thread::hardware_concurrency()),
+                              static_cast<int64_t>(8));
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    vector<int64_t> values;
+    values.reserve(n);
+
+    for (int64_t k = 0; k < n; k++) values.push_back(static_cast<int64_t>(xorshift(state) >> 40));
+
+    rb_tree<int> tree;
+
+    for (int64_t k = 0; k < tree_n; k++) tree.insert(static_cast<int>(xorshift(state) >> 40));
+
+    printf("%lld hardware threads\n", (long long) std::thread::hardware_concurrency());
+
+    int64_t checksum = 0;
+
+    double seconds = time_it([&]() {
+        for (int64_t r = 0; r < rounds; r++) {
+            for (int64_t k = 0; k < n; k++) checksum += values[k];
+        }
+    });
+
+    report("serial sum", n, n*rounds, seconds);
+
+    auto add = [](int64_t a, int64_t b) { return a + b; };
+
+    for (int64_t threads = 1; threads <= max_threads; threads *= 2) {
+        thread_pool pool(threads);
+
+        printf("%lld threads:\n", (long long) threads);
+
+        seconds = time_it([&]() {
+            for (int64_t r = 0; r < rounds; r++) {
+                checksum += pool.parallel_reduce(0, n, static_cast<int64_t>(0),
+                                                 [&values](int64_t k) { return values[k]; }, add);
+            }
+        });
+
+        report("vector parallel_reduce", n, n*rounds, seconds);
+
+        seconds = time_it([&]() {
+            for (int64_t r = 0; r < rounds; r++) {
+                checksum += parallel_reduce(pool, tree, static_cast<int64_t>(0),
+                                            [](const int& v) { return static_cast<int64_t>(v); }, add);
+            }
+        });
+
+        report("rb_tree parallel_reduce", tree_n, tree_n*rounds, seconds);
+    }
+
+    do_not_optimize(checksum);
+}
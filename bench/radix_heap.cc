@@ -0,0 +1,43 @@
+#include "bench.hpp"
+#include "../src/d_ary_heap.hpp"
+#include "../src/heap.hpp"
+#include "../src/radix_heap.hpp"
+
+// Keeps max_heap usable as a min heap of timestamps.
+struct negated_max_heap {
+    max_heap<int64_t> heap;
+
+    void insert(int64_t t) { this->heap.insert(-t); }
+    int64_t pop() { return -this->heap.pop(); }
+};
+
+// Event loop simulation: `pending` timers are outstanding, and each popped
+// timestamp schedules a new event a random delay in the future, so the
+// popped keys never decrease.
+template <typename H> void event_loop(const char* name, int64_t pending, int64_t events) {
+    H heap;
+    uint64_t state = 88172645463325252ull;
+    int64_t now = 0;
+
+    for (int64_t k = 0; k < pending; k++) heap.insert(static_cast<int64_t>(xorshift(state) % 1000000));
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < events; k++) {
+            now = heap.pop();
+            heap.insert(now + 1 + static_cast<int64_t>(xorshift(state) % 1000000));
+        }
+    });
+
+    do_not_optimize(now);
+    report(name, pending, 2*events, seconds);
+}
+
+int main() {
+    const int64_t events = 10000000;
+
+    for (int64_t pending = 1000; pending <= 1000000; pending *= 10) {
+        event_loop<negated_max_heap>("max_heap (negated)", pending, events);
+        event_loop<d_ary_min_heap<int64_t, 4>>("d_ary_heap<4> (min)", pending, events);
+        event_loop<radix_heap<int64_t>>("radix_heap", pending, events);
+    }
+}
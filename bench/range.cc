@@ -0,0 +1,77 @@
+#include "bench.hpp"
+#include "../src/b_tree.hpp"
+#include "../src/list.hpp"
+#include "../src/rb_tree.hpp"
+#include <new>
+#include <stdlib.h>
+
+static int64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+// Times `queries` scans of a window of `width` keys at random offsets and
+// reports the allocations made per scan.
+template <typename F> void measure(const char* name, int64_t n, int64_t width, int64_t queries, F scan) {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    int64_t checksum = 0,
+            before = allocations;
+
+    double seconds = time_it([&]() {
+        for (int64_t q = 0; q < queries; q++) {
+            int lo = static_cast<int>(xorshift(state) % static_cast<uint64_t>(n));
+            checksum += scan(lo, lo + static_cast<int>(width));
+        }
+    });
+
+    do_not_optimize(checksum);
+    report(name, n, queries, seconds);
+    printf("%-28s width=%lld, %lld allocations per scan\n", "", (long long) width,
+           (long long) ((allocations - before) / queries));
+}
+
+int main() {
+    for (int64_t n = 10000; n <= 1000000; n *= 10) {
+        rb_tree<int> r;
+        b_tree<int> b;
+
+        for (int64_t k = 0; k < n; k++) {
+            r.insert(static_cast<int>(k));
+            b.insert(static_cast<int>(k));
+        }
+
+        int64_t width = 100,
+                queries = 20000000 / n;
+
+        // What a range query took before: the whole tree into a list.
+        measure("inorder_traversal + filter", n, width, queries, [&](int lo, int hi) {
+            int64_t sum = 0;
+
+            for (int v : inorder_traversal(r)) {
+                if (lo <= v && v < hi) sum += v;
+            }
+
+            return sum;
+        });
+
+        queries = 1000000;
+
+        measure("rb_tree for_each_in_range", n, width, queries, [&](int lo, int hi) {
+            int64_t sum = 0;
+            r.for_each_in_range(lo, hi, [&](int v) { sum += v; });
+            return sum;
+        });
+
+        measure("b_tree for_each_in_range", n, width, queries, [&](int lo, int hi) {
+            int64_t sum = 0;
+            b.for_each_in_range(lo, hi, [&](int v) { sum += v; });
+            return sum;
+        });
+    }
+}
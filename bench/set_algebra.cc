@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include "../src/set.hpp"
+#include <new>
+#include <stdlib.h>
+
+// Every allocation in the process goes through here, so the benchmark
+// can report how many each operation performed.
+static int64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+// Times `rounds` calls of op and reports the allocations made per call.
+template <typename F> void measure(const char* name, int64_t n, int64_t rounds, F op) {
+    int64_t checksum = 0,
+            before = allocations;
+
+    double seconds = time_it([&]() {
+        for (int64_t r = 0; r < rounds; r++) checksum += op().size();
+    });
+
+    do_not_optimize(checksum);
+    report(name, n, n*rounds, seconds);
+    printf("%-28s %lld allocations per call\n", "",
+           (long long) ((allocations - before) / rounds));
+}
+
+// a and b of n and n/ratio random values out of 2n.
+template <typename Set> void fill(Set& a, Set& b, int64_t n, int64_t ratio, uint64_t& state) {
+    for (int64_t k = 0; k < n; k++) a.insert(static_cast<int>(xorshift(state) % (2*n)));
+    for (int64_t k = 0; k < n / ratio; k++) b.insert(static_cast<int>(xorshift(state) % (2*n)));
+}
+
+int main() {
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+
+    for (int64_t n = 1000; n <= 100000; n *= 10) {
+        set<int> a, b;
+
+        fill(a, b, n, 1, state);
+
+        int64_t rounds = 2000000 / n;
+
+        measure("set a + b", n, rounds, [&]() { return a + b; });
+        measure("set a - b", n, rounds, [&]() { return a - b; });
+        measure("set_union(a, b)", n, rounds, [&]() { return set_union(a, b); });
+        measure("set_difference(a, b)", n, rounds, [&]() { return set_difference(a, b); });
+        measure("set_intersection(a, b)", n, rounds, [&]() { return set_intersection(a, b); });
+        measure("symmetric_difference(a, b)", n, rounds, [&]() { return symmetric_difference(a, b); });
+    }
+
+    // A large set against one a thousandth its size, where split and join
+    // touch only the paths to the small set's values.
+    int64_t n = 1000000;
+    set<int> a, b;
+
+    fill(a, b, n, 1000, state);
+
+    measure("large a - small b", n, 20, [&]() { return a - b; });
+    measure("large a, small b intersected", n, 20, [&]() { return set_intersection(a, b); });
+}
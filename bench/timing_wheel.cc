@@ -0,0 +1,69 @@
+#include "bench.hpp"
+#include "../src/indexed_heap.hpp"
+#include "../src/timing_wheel.hpp"
+
+// The heap side of the comparison: an indexed min heap of expiry ticks,
+// which cancels by handle in O(log n) instead of searching.
+struct timeout_heap {
+    typedef indexed_heap<uint64_t, std::less<uint64_t>>::handle handle;
+
+    indexed_heap<uint64_t, std::less<uint64_t>> heap;
+    uint64_t now = 0;
+
+    handle schedule(uint64_t delay, int64_t) { return this->heap.insert(this->now + delay); }
+    void cancel(handle h) { this->heap.erase(h); }
+
+    template <typename F> int64_t advance(uint64_t ticks, F fn) {
+        int64_t fired = 0;
+        this->now += ticks;
+
+        while (!this->heap.is_empty() && this->heap.root() <= this->now) {
+            fn(this->heap.pop());
+            ++fired;
+        }
+
+        return fired;
+    }
+};
+
+// Connection timeouts: ten timers are armed per tick with a delay of
+// 10^4 to 2*10^4 ticks, and nine in ten are cancelled 5000 ticks later,
+// before they can fire. The window of pending handles is a ring buffer.
+template <typename W, typename H> void timeouts(const char* name, int64_t timers) {
+    W wheel;
+    const int64_t per_tick = 10, window = 5000 * per_tick;
+
+    H* pending = new H[window];
+    bool* doomed = new bool[window]();
+    uint64_t state = 88172645463325252ull;
+    int64_t fired = 0;
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < timers; k++) {
+            int64_t slot = k % window;
+
+            if (doomed[slot]) wheel.cancel(pending[slot]);
+
+            uint64_t r = xorshift(state);
+
+            pending[slot] = wheel.schedule(10000 + r % 10000, k);
+            doomed[slot] = (r >> 32) % 10 != 0;
+
+            if (k % per_tick == per_tick-1)
+                fired += wheel.advance(1, [](int64_t) {});
+        }
+    });
+
+    do_not_optimize(fired);
+    report(name, timers, timers, seconds);
+
+    delete[] pending;
+    delete[] doomed;
+}
+
+int main() {
+    for (int64_t timers = 1000000; timers <= 10000000; timers *= 10) {
+        timeouts<timeout_heap, timeout_heap::handle>("indexed_heap", timers);
+        timeouts<timing_wheel<int64_t>, timing_wheel<int64_t>::handle>("timing_wheel", timers);
+    }
+}
@@ -0,0 +1,134 @@
+#include "bench.hpp"
+#include "../src/list.hpp"
+#include "../src/rb_tree.hpp"
+#include "../src/stack.hpp"
+#include <new>
+#include <stdlib.h>
+
+static int64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+// The recursive traversals the iterative ones replaced.
+template <typename T> void recursive_inorder(rb_node<T>* node, list<T>* out) {
+    if (node == nullptr) return;
+
+    recursive_inorder(node->left(), out);
+    if (out != nullptr) out->push_back(node->value());
+    recursive_inorder(node->right(), out);
+}
+
+template <typename T> void recursive_postorder(rb_node<T>* node, list<T>* out) {
+    if (node == nullptr) return;
+
+    recursive_postorder(node->left(), out);
+    recursive_postorder(node->right(), out);
+    if (out != nullptr) out->push_back(node->value());
+}
+
+template <typename F> void measure(const char* name, int64_t n, int64_t rounds, F traverse) {
+    int64_t checksum = 0,
+            before = allocations;
+
+    double seconds = time_it([&]() {
+        for (int64_t r = 0; r < rounds; r++) checksum += traverse();
+    });
+
+    do_not_optimize(checksum);
+    report(name, n, n*rounds, seconds);
+    printf("%-28s %lld allocations per walk\n", "", (long long) ((allocations - before) / rounds));
+}
+
+// Pushes and pops in the pattern of a depth-first walk that never holds
+// more than `depth` entries, counting allocations.
+template <typename S> void walk(const char* name, int64_t depth, int64_t ops,
+                                void (*push)(S&, int), int (*pop)(S&)) {
+    S s;
+    int64_t checksum = 0,
+            before = allocations;
+
+    double seconds = time_it([&]() {
+        for (int64_t k = 0; k < ops; k += depth) {
+            for (int64_t d = 0; d < depth; d++) push(s, static_cast<int>(k + d));
+            for (int64_t d = 0; d < depth; d++) checksum += pop(s);
+        }
+    });
+
+    do_not_optimize(checksum);
+    report(name, depth, 2*ops, seconds);
+    printf("%-28s %lld allocations\n", "", (long long) (allocations - before));
+}
+
+int main() {
+    const int64_t n = 1000000, rounds = 10;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    rb_tree<int> tree;
+
+    for (int64_t k = 0; k < n; k++) tree.insert(static_cast<int>(xorshift(state) >> 33));
+
+    // The walks alone, without building an output list.
+    measure("inorder, recursive", n, rounds, [&]() {
+        list<int>* none = nullptr;
+        recursive_inorder(tree.root(), none);
+        return 0;
+    });
+
+    measure("inorder, iterative", n, rounds, [&]() {
+        list<int>* none = nullptr;
+        inorder_traversal(tree.root(), none);
+        return 0;
+    });
+
+    measure("inorder list, recursive", n, rounds, [&]() {
+        list<int> out;
+        recursive_inorder(tree.root(), &out);
+        return out.size();
+    });
+
+    measure("inorder list, iterative", n, rounds, [&]() { return inorder_traversal(tree).size(); });
+
+    // Summing the values, through a list and streamed.
+    measure("inorder sum via list", n, rounds, [&]() {
+        int64_t sum = 0;
+        for (int v : inorder_traversal(tree)) sum += v;
+        return sum;
+    });
+
+    measure("inorder sum, visitor", n, rounds, [&]() {
+        int64_t sum = 0;
+        visit_inorder(tree, [&sum](int v) { sum += v; });
+        return sum;
+    });
+
+#if defined(__cpp_impl_coroutine)
+    measure("inorder sum, generator", n, rounds, [&]() {
+        int64_t sum = 0;
+        for (int v : inorder(tree)) sum += v;
+        return sum;
+    });
+#endif
+
+    measure("postorder list, recursive", n, rounds, [&]() {
+        list<int> out;
+        recursive_postorder(tree.root(), &out);
+        return out.size();
+    });
+
+    measure("postorder list, iterative", n, rounds, [&]() { return postorder_traversal(tree).size(); });
+
+    for (int64_t depth = 40; depth <= 160; depth *= 2) {
+        walk<list<int>>("list as a stack", depth, 10000000,
+                        [](list<int>& s, int v) { s.push_back(v); },
+                        [](list<int>& s) { return s.pop_back(); });
+        walk<stack<int>>("stack", depth, 10000000,
+                         [](stack<int>& s, int v) { s.push(v); },
+                         [](stack<int>& s) { return s.pop(); });
+    }
+}
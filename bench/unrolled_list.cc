@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include "../src/list.hpp"
+#include "../src/unrolled_list.hpp"
+
+const int64_t n = 1000000;
+
+void list_rows() {
+    list<int> l;
+    uint64_t state = 88172645463325252ull;
+    int64_t checksum = 0;
+
+    for (int64_t k = 0; k < n; k++) l.push_back(static_cast<int>(k));
+
+    double seconds = time_it([&]() {
+        for (int64_t pass = 0; pass < 10; pass++) {
+            for (linked_node<int>* node = l.front(); node != nullptr; node = node->next())
+                checksum += node->value();
+        }
+    });
+
+    report("list iteration", n, 10*n, seconds);
+
+    const int64_t lookups = 1000;
+
+    seconds = time_it([&]() {
+        for (int64_t k = 0; k < lookups; k++) checksum += l[xorshift(state) % n];
+    });
+
+    report("list operator[]", n, lookups, seconds);
+    do_not_optimize(checksum);
+}
+
+template <int64_t B> void unrolled_rows(const char* iteration, const char* indexed) {
+    unrolled_list<int, B> l;
+    uint64_t state = 88172645463325252ull;
+    int64_t checksum = 0;
+
+    for (int64_t k = 0; k < n; k++) l.push_back(static_cast<int>(k));
+
+    double seconds = time_it([&]() {
+        for (int64_t pass = 0; pass < 10; pass++) {
+            l.for_each([&checksum](int value) { checksum += value; });
+        }
+    });
+
+    report(iteration, n, 10*n, seconds);
+
+    const int64_t lookups = 100000;
+
+    seconds = time_it([&]() {
+        for (int64_t k = 0; k < lookups; k++) checksum += l[xorshift(state) % n];
+    });
+
+    report(indexed, n, lookups, seconds);
+    do_not_optimize(checksum);
+}
+
+int main() {
+    list_rows();
+    unrolled_rows<16>("unrolled_list<16> iteration", "unrolled_list<16> operator[]");
+    unrolled_rows<32>("unrolled_list<32> iteration", "unrolled_list<32> operator[]");
+    unrolled_rows<64>("unrolled_list<64> iteration", "unrolled_list<64> operator[]");
+}
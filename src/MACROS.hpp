@@ -8,10 +8,21 @@
 #define MAX(x,y) ((x > y) ? x : y)
 #define MIN(x,y) ((x < y) ? x : y)
 
-inline int64_t log2(int64_t x) {
+// Number of bits needed to represent x, i.e. one past the index of its
+// highest set bit; 0 for x == 0.
+inline int64_t bit_width(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (x == 0 ? 0 : 64 - __builtin_clzll(x));
+#else
     int64_t result = 0;
-    while (x >>= 1) ++result;
+    while (x) { x >>= 1; ++result; }
     return result;
+#endif
+}
+
+// floor(log2(x)) for x > 0; 0 otherwise.
+inline int64_t log2(int64_t x) {
+    return (x <= 0 ? 0 : bit_width(static_cast<uint64_t>(x)) - 1);
 }
 
 inline list<bool> dec_to_bin(int64_t N) {
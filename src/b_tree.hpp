@@ -0,0 +1,1054 @@
+#ifndef B_TREE_H
+#define B_TREE_H
+
+#pragma once
+#include <assert.h>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include "pool.hpp"
+#include "stack.hpp"
+#include "vector.hpp"
+
+template <typename T, int64_t B> class b_tree_iterator;
+
+// B+tree, a drop-in for rb_tree as the backend of set and map. Values
+// live in leaves of up to B values, which are linked both ways for
+// iteration; branches hold up to B separator keys and B+1 children. A
+// lookup reads about log_B(n) nodes and compares inside contiguous
+// arrays, where rb_tree follows log2(n) pointers to scattered nodes. The
+// default B fills four cache lines with a leaf's values.
+//
+// Every leaf is at the same depth. A full node is split in half on
+// insert, and a node left under half full by a removal borrows from a
+// sibling or is merged with it. As in rb_tree, equal values are all
+// kept. Nodes come from two node_pools, which clear() and the destructor
+// release at once.
+template <typename T, int64_t B = (256 / sizeof(T) > 8 ? 256 / sizeof(T) : 8)> class b_tree {
+    static_assert(B >= 4, "Nodes need room for at least four values");
+
+    private:
+        struct node {
+            int64_t count;
+
+            node() : count(0) {}
+        };
+
+        struct leaf : node {
+            leaf *next, *prev;
+            alignas(T) unsigned char storage[B * sizeof(T)];
+
+            leaf() : next(nullptr), prev(nullptr) {}
+
+            T* items() { return reinterpret_cast<T*>(this->storage); }
+            T& item(int64_t idx) { return this->items()[idx]; }
+        };
+
+        // Every value under children[k] is <= key(k), and every value
+        // under children[k+1] is >= it.
+        struct branch : node {
+            node* children[B + 1];
+            alignas(T) unsigned char storage[B * sizeof(T)];
+
+            T* keys() { return reinterpret_cast<T*>(this->storage); }
+            T& key(int64_t idx) { return this->keys()[idx]; }
+        };
+
+        // A branch on the way down from the root, and which child was taken.
+        struct step {
+            branch* at;
+            int64_t idx;
+        };
+
+        int64_t s, height;
+        node* tree_root;
+        leaf *head, *tail;
+        node_pool<leaf> leaves;
+        node_pool<branch> branches;
+
+        static int64_t lower(T* items, int64_t count, const T& value);
+        static int64_t upper(T* items, int64_t count, const T& value);
+
+        leaf* descend(const T& value, stack<step>* path) const;
+        bool next_leaf(stack<step>& path, leaf*& l) const;
+
+        leaf* split(leaf* l);
+        void insert_into(leaf* l, int64_t pos, T value);
+        void insert_into(branch* b, int64_t idx, T key, node* child);
+        void insert_child(stack<step>& path, T key, node* child);
+
+        bool erase(const T& value, const T* item);
+        void remove_child(branch* p, int64_t idx);
+        void rebalance(stack<step>& path, leaf* l);
+        void rebalance(stack<step>& path, branch* b);
+        void shrink(stack<step>& path, branch* p);
+
+        node* clone(node* n, int64_t level, leaf*& last);
+        void destroy(node* n, int64_t level);
+        static const T& leftmost(node* n, int64_t level);
+
+        void merge(const b_tree& other, bool mine, bool common, bool theirs);
+
+        b_tree_iterator<T,B> at(leaf* l, int64_t pos) const;
+
+        friend class b_tree_iterator<T,B>;
+    public:
+        typedef b_tree_iterator<T,B> iterator;
+        typedef b_tree_iterator<T,B> const_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        b_tree() : s(0), height(0), tree_root(nullptr), head(nullptr), tail(nullptr), leaves(16),
+                   branches(4) {}
+        b_tree(const b_tree& copy);
+        b_tree(b_tree&& other);
+
+        ~b_tree() { this->clear(); }
+
+        b_tree& operator=(b_tree copy);
+
+        template <typename It> static b_tree from_sorted(It first, It last);
+        template <typename Range> static b_tree from_sorted(const Range& range);
+
+        template <typename It> void assign_sorted(It first, It last, bool unique = false);
+
+        void unite(const b_tree& other);
+        void intersect(const b_tree& other);
+        void subtract(const b_tree& other);
+        void symmetric_subtract(const b_tree& other);
+
+        T* insert(T value);
+
+        void remove(T value);
+        void remove(T* item);
+
+        T* search(T value) const;
+        T* find(T value) const;
+
+        iterator lower_bound(T value) const;
+        iterator upper_bound(T value) const;
+        std::pair<iterator,iterator> equal_range(T value) const;
+
+        T* floor(T value) const;
+        T* ceiling(T value) const;
+
+        template <typename F> void for_each_in_range(T lo, T hi, F fn) const;
+
+        int64_t size() const;
+        int64_t depth() const;
+
+        void clear();
+        void swap(b_tree& other);
+
+        iterator begin() const;
+        iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        reverse_iterator rbegin() const;
+        reverse_iterator rend() const;
+};
+
+// In-order bidirectional iterator over the leaf chain. The end position
+// is a null leaf; the tree's last leaf is remembered so that
+// decrementing end() reaches the maximum.
+template <typename T, int64_t B> class b_tree_iterator {
+    private:
+        typedef typename b_tree<T,B>::leaf leaf;
+
+        leaf* l;
+        int64_t pos;
+        leaf* const* last;
+
+        friend class b_tree<T,B>;
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        b_tree_iterator(leaf* l = nullptr, int64_t pos = 0, leaf* const* last = nullptr) : l(l), pos(pos),
+                                                                                          last(last) {}
+
+        reference operator*() const { return this->l->item(this->pos); }
+        pointer operator->() const { return &this->l->item(this->pos); }
+
+        b_tree_iterator& operator++() {
+            if (++this->pos == this->l->count) {
+                this->l = this->l->next;
+                this->pos = 0;
+            }
+
+            return *this;
+        }
+
+        b_tree_iterator operator++(int) {
+            b_tree_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        b_tree_iterator& operator--() {
+            if (this->l == nullptr) {
+                this->l = *this->last;
+                this->pos = this->l->count - 1;
+            } else if (this->pos-- == 0) {
+                this->l = this->l->prev;
+                this->pos = this->l->count - 1;
+            }
+
+            return *this;
+        }
+
+        b_tree_iterator operator--(int) {
+            b_tree_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        friend bool operator==(const b_tree_iterator& a, const b_tree_iterator& b) {
+            return (a.l == b.l && a.pos == b.pos);
+        }
+
+        friend bool operator!=(const b_tree_iterator& a, const b_tree_iterator& b) { return !(a == b); }
+};
+
+// First index in items[0, count) whose value is not less than value.
+template <typename T, int64_t B> int64_t b_tree<T,B>::lower(T* items, int64_t count, const T& value) {
+    int64_t lo = 0, hi = count;
+
+    while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+
+        if (items[mid] < value) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+// First index in items[0, count) whose value is greater than value.
+template <typename T, int64_t B> int64_t b_tree<T,B>::upper(T* items, int64_t count, const T& value) {
+    int64_t lo = 0, hi = count;
+
+    while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+
+        if (!(value < items[mid])) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+// The leaf where the values not less than value start, though they may
+// all be in the leaves after it. The branches passed are pushed onto
+// path when one is given.
+template <typename T, int64_t B>
+typename b_tree<T,B>::leaf* b_tree<T,B>::descend(const T& value, stack<step>* path) const {
+    node* n = this->tree_root;
+
+    for (int64_t level = this->height; level > 0; level--) {
+        branch* b = static_cast<branch*>(n);
+        int64_t idx = lower(b->keys(), b->count, value);
+
+        if (path != nullptr) path->push(step{ b, idx });
+
+        n = b->children[idx];
+    }
+
+    return static_cast<leaf*>(n);
+}
+
+// Moves l, and the path down to it, on to the next leaf. Returns false
+// at the last leaf.
+template <typename T, int64_t B> bool b_tree<T,B>::next_leaf(stack<step>& path, leaf*& l) const {
+    if (l->next == nullptr)
+        return false;
+
+    while (path.top().idx == path.top().at->count) path.pop();
+
+    node* n = path.top().at->children[++path.top().idx];
+
+    while (path.size() < this->height) {
+        branch* b = static_cast<branch*>(n);
+
+        path.push(step{ b, 0 });
+        n = b->children[0];
+    }
+
+    l = static_cast<leaf*>(n);
+
+    return true;
+}
+
+// Moves the upper half of a full leaf into a new leaf after it.
+template <typename T, int64_t B> typename b_tree<T,B>::leaf* b_tree<T,B>::split(leaf* l) {
+    leaf* n = this->leaves.acquire();
+    int64_t half = l->count / 2;
+
+    for (int64_t k = half; k < l->count; k++) {
+        new (&n->item(k - half)) T(std::move(l->item(k)));
+        l->item(k).~T();
+    }
+
+    n->count = l->count - half;
+    l->count = half;
+
+    n->prev = l;
+    n->next = l->next;
+
+    if (l->next != nullptr) l->next->prev = n;
+    else this->tail = n;
+
+    l->next = n;
+
+    return n;
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::insert_into(leaf* l, int64_t pos, T value) {
+    T* items = l->items();
+
+    if (pos == l->count) {
+        new (items + pos) T(std::move(value));
+    } else {
+        new (items + l->count) T(std::move(items[l->count - 1]));
+
+        for (int64_t k = l->count - 1; k > pos; k--) {
+            items[k] = std::move(items[k - 1]);
+        }
+
+        items[pos] = std::move(value);
+    }
+
+    ++l->count;
+}
+
+// Puts key at idx and child just right of it.
+template <typename T, int64_t B> void b_tree<T,B>::insert_into(branch* b, int64_t idx, T key, node* child) {
+    T* keys = b->keys();
+
+    if (idx == b->count) {
+        new (keys + idx) T(std::move(key));
+    } else {
+        new (keys + b->count) T(std::move(keys[b->count - 1]));
+
+        for (int64_t k = b->count - 1; k > idx; k--) {
+            keys[k] = std::move(keys[k - 1]);
+        }
+
+        keys[idx] = std::move(key);
+    }
+
+    for (int64_t k = b->count + 1; k > idx + 1; k--) {
+        b->children[k] = b->children[k - 1];
+    }
+
+    b->children[idx + 1] = child;
+    ++b->count;
+}
+
+// Hangs child, split off from the child the top of path leads to, just
+// right of it under key. A full branch is split in turn and its middle
+// key carried up, growing a new root when the old one splits.
+template <typename T, int64_t B> void b_tree<T,B>::insert_child(stack<step>& path, T key, node* child) {
+    while (!path.is_empty()) {
+        step up = path.pop();
+        branch* b = up.at;
+
+        if (b->count < B) {
+            this->insert_into(b, up.idx, std::move(key), child);
+            return;
+        }
+
+        branch* n = this->branches.acquire();
+        int64_t half = B / 2;
+        T middle = std::move(b->key(half));
+
+        for (int64_t k = half + 1; k < B; k++) {
+            new (&n->key(k - half - 1)) T(std::move(b->key(k)));
+        }
+
+        for (int64_t k = half + 1; k <= B; k++) {
+            n->children[k - half - 1] = b->children[k];
+        }
+
+        for (int64_t k = half; k < B; k++) b->key(k).~T();
+
+        n->count = B - half - 1;
+        b->count = half;
+
+        if (up.idx <= half) this->insert_into(b, up.idx, std::move(key), child);
+        else this->insert_into(n, up.idx - half - 1, std::move(key), child);
+
+        key = std::move(middle);
+        child = n;
+    }
+
+    branch* root = this->branches.acquire();
+
+    new (&root->key(0)) T(std::move(key));
+    root->children[0] = this->tree_root;
+    root->children[1] = child;
+    root->count = 1;
+
+    this->tree_root = root;
+    ++this->height;
+}
+
+// Removes the first value in the run of values equivalent to value that
+// is == value, or, when item is given, that is item itself.
+template <typename T, int64_t B> bool b_tree<T,B>::erase(const T& value, const T* item) {
+    if (this->tree_root == nullptr)
+        return false;
+
+    stack<step> path;
+    leaf* l = this->descend(value, &path);
+    int64_t pos = lower(l->items(), l->count, value);
+
+    while (true) {
+        if (pos == l->count) {
+            if (!this->next_leaf(path, l)) return false;
+            pos = 0;
+        }
+
+        T& current = l->item(pos);
+
+        if (value < current)
+            return false;
+
+        if (item != nullptr ? &current == item : current == value)
+            break;
+
+        ++pos;
+    }
+
+    T* items = l->items();
+
+    for (int64_t k = pos; k < l->count - 1; k++) {
+        items[k] = std::move(items[k + 1]);
+    }
+
+    items[--l->count].~T();
+    --this->s;
+
+    if (path.is_empty()) {
+        // l is the root.
+        if (l->count == 0) {
+            this->leaves.release(l);
+            this->tree_root = this->head = this->tail = nullptr;
+        }
+    } else if (l->count < B / 2) {
+        this->rebalance(path, l);
+    }
+
+    return true;
+}
+
+// Drops key idx and the child right of it.
+template <typename T, int64_t B> void b_tree<T,B>::remove_child(branch* p, int64_t idx) {
+    T* keys = p->keys();
+
+    for (int64_t k = idx; k < p->count - 1; k++) {
+        keys[k] = std::move(keys[k + 1]);
+    }
+
+    keys[p->count - 1].~T();
+
+    for (int64_t k = idx + 1; k < p->count; k++) {
+        p->children[k] = p->children[k + 1];
+    }
+
+    --p->count;
+}
+
+// l is under half full: take a value from a sibling that can spare one,
+// or else merge l with a sibling.
+template <typename T, int64_t B> void b_tree<T,B>::rebalance(stack<step>& path, leaf* l) {
+    step up = path.pop();
+    branch* p = up.at;
+    int64_t i = up.idx;
+
+    leaf *L = (i > 0 ? static_cast<leaf*>(p->children[i - 1]) : nullptr),
+         *R = (i < p->count ? static_cast<leaf*>(p->children[i + 1]) : nullptr);
+
+    if (R != nullptr && R->count > B / 2) {
+        new (&l->item(l->count++)) T(std::move(R->item(0)));
+
+        for (int64_t k = 0; k < R->count - 1; k++) {
+            R->item(k) = std::move(R->item(k + 1));
+        }
+
+        R->item(--R->count).~T();
+        p->key(i) = R->item(0);
+
+        return;
+    }
+
+    if (L != nullptr && L->count > B / 2) {
+        this->insert_into(l, 0, std::move(L->item(L->count - 1)));
+
+        L->item(--L->count).~T();
+        p->key(i - 1) = l->item(0);
+
+        return;
+    }
+
+    leaf *left = (R != nullptr ? l : L),
+         *right = (R != nullptr ? R : l);
+
+    for (int64_t k = 0; k < right->count; k++) {
+        new (&left->item(left->count + k)) T(std::move(right->item(k)));
+        right->item(k).~T();
+    }
+
+    left->count += right->count;
+    left->next = right->next;
+
+    if (right->next != nullptr) right->next->prev = left;
+    else this->tail = left;
+
+    this->leaves.release(right);
+    this->remove_child(p, (R != nullptr ? i : i - 1));
+    this->shrink(path, p);
+}
+
+// The same for a branch; keys move through the separator in the parent.
+template <typename T, int64_t B> void b_tree<T,B>::rebalance(stack<step>& path, branch* b) {
+    step up = path.pop();
+    branch* p = up.at;
+    int64_t i = up.idx;
+
+    branch *L = (i > 0 ? static_cast<branch*>(p->children[i - 1]) : nullptr),
+           *R = (i < p->count ? static_cast<branch*>(p->children[i + 1]) : nullptr);
+
+    if (R != nullptr && R->count > B / 2) {
+        new (&b->key(b->count)) T(std::move(p->key(i)));
+        b->children[++b->count] = R->children[0];
+
+        p->key(i) = std::move(R->key(0));
+
+        for (int64_t k = 0; k < R->count - 1; k++) {
+            R->key(k) = std::move(R->key(k + 1));
+        }
+
+        for (int64_t k = 0; k < R->count; k++) {
+            R->children[k] = R->children[k + 1];
+        }
+
+        R->key(--R->count).~T();
+
+        return;
+    }
+
+    if (L != nullptr && L->count > B / 2) {
+        node* moved = L->children[L->count];
+
+        this->insert_into(b, 0, std::move(p->key(i - 1)), b->children[0]);
+        b->children[0] = moved;
+
+        p->key(i - 1) = std::move(L->key(L->count - 1));
+        L->key(--L->count).~T();
+
+        return;
+    }
+
+    branch *left = (R != nullptr ? b : L),
+           *right = (R != nullptr ? R : b);
+    int64_t separator = (R != nullptr ? i : i - 1);
+
+    new (&left->key(left->count)) T(std::move(p->key(separator)));
+
+    for (int64_t k = 0; k < right->count; k++) {
+        new (&left->key(left->count + 1 + k)) T(std::move(right->key(k)));
+        right->key(k).~T();
+    }
+
+    for (int64_t k = 0; k <= right->count; k++) {
+        left->children[left->count + 1 + k] = right->children[k];
+    }
+
+    left->count += right->count + 1;
+
+    this->branches.release(right);
+    this->remove_child(p, separator);
+    this->shrink(path, p);
+}
+
+// p lost a child to a merge below it.
+template <typename T, int64_t B> void b_tree<T,B>::shrink(stack<step>& path, branch* p) {
+    if (!path.is_empty()) {
+        if (p->count < B / 2) this->rebalance(path, p);
+        return;
+    }
+
+    // p is the root; once it is down to one child, that child takes over.
+    if (p->count == 0) {
+        this->tree_root = p->children[0];
+        --this->height;
+
+        this->branches.release(p);
+    }
+}
+
+template <typename T, int64_t B>
+typename b_tree<T,B>::node* b_tree<T,B>::clone(node* n, int64_t level, leaf*& last) {
+    if (level == 0) {
+        leaf *from = static_cast<leaf*>(n),
+             *l = this->leaves.acquire();
+
+        for (int64_t k = 0; k < from->count; k++) {
+            new (&l->item(k)) T(from->item(k));
+        }
+
+        l->count = from->count;
+        l->prev = last;
+
+        if (last != nullptr) last->next = l;
+        else this->head = l;
+
+        last = l;
+
+        return l;
+    }
+
+    branch *from = static_cast<branch*>(n),
+           *b = this->branches.acquire();
+
+    for (int64_t k = 0; k < from->count; k++) {
+        new (&b->key(k)) T(from->key(k));
+    }
+
+    for (int64_t k = 0; k <= from->count; k++) {
+        b->children[k] = this->clone(from->children[k], level - 1, last);
+    }
+
+    b->count = from->count;
+
+    return b;
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::destroy(node* n, int64_t level) {
+    if (level == 0) {
+        leaf* l = static_cast<leaf*>(n);
+
+        for (int64_t k = 0; k < l->count; k++) l->item(k).~T();
+
+        return;
+    }
+
+    branch* b = static_cast<branch*>(n);
+
+    for (int64_t k = 0; k < b->count; k++) b->key(k).~T();
+    for (int64_t k = 0; k <= b->count; k++) this->destroy(b->children[k], level - 1);
+}
+
+// The smallest value under n, which sits level levels above the leaves.
+template <typename T, int64_t B> const T& b_tree<T,B>::leftmost(node* n, int64_t level) {
+    for (; level > 0; level--) n = static_cast<branch*>(n)->children[0];
+
+    return static_cast<leaf*>(n)->item(0);
+}
+
+// Copies the shape node for node, so no splitting is done.
+template <typename T, int64_t B> b_tree<T,B>::b_tree(const b_tree& copy) : b_tree() {
+    if (copy.tree_root == nullptr)
+        return;
+
+    leaf* last = nullptr;
+
+    this->tree_root = this->clone(copy.tree_root, copy.height, last);
+    this->tail = last;
+    this->height = copy.height;
+    this->s = copy.s;
+}
+
+template <typename T, int64_t B> b_tree<T,B>::b_tree(b_tree&& other) : b_tree() {
+    this->swap(other);
+}
+
+template <typename T, int64_t B> b_tree<T,B>& b_tree<T,B>::operator=(b_tree copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T, int64_t B> template <typename It>
+b_tree<T,B> b_tree<T,B>::from_sorted(It first, It last) {
+    b_tree tree;
+
+    tree.assign_sorted(first, last);
+
+    return tree;
+}
+
+template <typename T, int64_t B> template <typename Range>
+b_tree<T,B> b_tree<T,B>::from_sorted(const Range& range) {
+    return from_sorted(range.begin(), range.end());
+}
+
+// Replaces the contents with the values of [first, last), which must be
+// sorted, in linear time. The values are spread evenly over as few leaves
+// as will hold them, and each level of branches is built the same way
+// over the one below. The range is walked twice, once to count it, so it
+// takes forward iterators. With unique, a run of == values is taken once.
+template <typename T, int64_t B> template <typename It>
+void b_tree<T,B>::assign_sorted(It first, It last, bool unique) {
+    this->clear();
+
+    int64_t n = 0;
+
+    for (It it = first; it != last; n++) {
+        It start = it++;
+
+        if (unique) {
+            while (it != last && *it == *start) ++it;
+        }
+    }
+
+    if (n == 0)
+        return;
+
+    vector<node*> level;
+    int64_t count = (n + B - 1) / B;
+
+    for (int64_t k = 0; k < count; k++) {
+        leaf* l = this->leaves.acquire();
+
+        l->count = n / count + (k < n % count);
+
+        for (int64_t j = 0; j < l->count; j++) {
+            new (&l->item(j)) T(*first);
+            ++first;
+
+            if (unique) {
+                while (first != last && *first == l->item(j)) ++first;
+            }
+        }
+
+        l->prev = this->tail;
+
+        if (this->tail != nullptr) this->tail->next = l;
+        else this->head = l;
+
+        this->tail = l;
+        level.push_back(l);
+    }
+
+    while (level.size() > 1) {
+        vector<node*> above;
+        int64_t children = level.size(),
+                groups = (children + B) / (B + 1),
+                next = 0;
+
+        for (int64_t k = 0; k < groups; k++) {
+            branch* b = this->branches.acquire();
+
+            b->count = children / groups + (k < children % groups) - 1;
+            b->children[0] = level[next++];
+
+            for (int64_t j = 0; j < b->count; j++) {
+                new (&b->key(j)) T(leftmost(level[next], this->height));
+                b->children[j + 1] = level[next++];
+            }
+
+            above.push_back(b);
+        }
+
+        level.swap(above);
+        ++this->height;
+    }
+
+    this->tree_root = level[0];
+    this->s = n;
+}
+
+// Merges the values of this tree and other and rebuilds the tree from
+// the ones that are only in this tree, in both, or only in other, as
+// asked, in O(n + m). Values that compare equivalent are taken to be the
+// same element, and one in both is kept as this tree's.
+template <typename T, int64_t B>
+void b_tree<T,B>::merge(const b_tree& other, bool mine, bool common, bool theirs) {
+    vector<T> merged;
+    iterator a = this->begin(), b = other.begin();
+
+    merged.reserve(this->s + other.s);
+
+    while (a != this->end() || b != other.end()) {
+        if (b == other.end() || (a != this->end() && *a < *b)) {
+            if (mine) merged.push_back(*a);
+            ++a;
+        } else if (a == this->end() || *b < *a) {
+            if (theirs) merged.push_back(*b);
+            ++b;
+        } else {
+            if (common) merged.push_back(*a);
+            ++a;
+            ++b;
+        }
+    }
+
+    this->assign_sorted(merged.begin(), merged.end());
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::unite(const b_tree& other) {
+    this->merge(other, true, true, true);
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::intersect(const b_tree& other) {
+    this->merge(other, false, true, false);
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::subtract(const b_tree& other) {
+    this->merge(other, true, false, false);
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::symmetric_subtract(const b_tree& other) {
+    this->merge(other, true, false, true);
+}
+
+// Equal values go after the ones already there. The pointer is valid
+// until the tree is next changed.
+template <typename T, int64_t B> T* b_tree<T,B>::insert(T value) {
+    if (this->tree_root == nullptr) {
+        leaf* l = this->leaves.acquire();
+        this->tree_root = this->head = this->tail = l;
+    }
+
+    stack<step> path;
+    node* n = this->tree_root;
+
+    for (int64_t level = this->height; level > 0; level--) {
+        branch* b = static_cast<branch*>(n);
+        int64_t idx = upper(b->keys(), b->count, value);
+
+        path.push(step{ b, idx });
+        n = b->children[idx];
+    }
+
+    leaf* l = static_cast<leaf*>(n);
+    int64_t pos = upper(l->items(), l->count, value);
+
+    if (l->count == B) {
+        leaf* r = this->split(l);
+
+        this->insert_child(path, r->item(0), r);
+
+        if (pos > l->count) {
+            pos -= l->count;
+            l = r;
+        }
+    }
+
+    this->insert_into(l, pos, std::move(value));
+    ++this->s;
+
+    return &l->item(pos);
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::remove(T value) {
+    this->erase(value, nullptr);
+}
+
+// item must point into this tree, as returned by search or insert.
+template <typename T, int64_t B> void b_tree<T,B>::remove(T* item) {
+    if (item == nullptr)
+        return;
+
+    T value = *item;
+
+    this->erase(value, item);
+}
+
+// Values that compare equal in the ordering without being ==, such as
+// pairs with the same key, are checked through their whole run.
+template <typename T, int64_t B> T* b_tree<T,B>::search(T value) const {
+    if (this->tree_root == nullptr)
+        return nullptr;
+
+    leaf* l = this->descend(value, nullptr);
+    int64_t pos = lower(l->items(), l->count, value);
+
+    while (true) {
+        if (pos == l->count) {
+            l = l->next;
+            pos = 0;
+        }
+
+        if (l == nullptr || value < l->item(pos))
+            return nullptr;
+
+        if (l->item(pos) == value)
+            return &l->item(pos);
+
+        ++pos;
+    }
+}
+
+// The first value that is neither less nor greater than value.
+template <typename T, int64_t B> T* b_tree<T,B>::find(T value) const {
+    if (this->tree_root == nullptr)
+        return nullptr;
+
+    leaf* l = this->descend(value, nullptr);
+    int64_t pos = lower(l->items(), l->count, value);
+
+    if (pos == l->count) {
+        l = l->next;
+        pos = 0;
+    }
+
+    return (l == nullptr || value < l->item(pos) ? nullptr : &l->item(pos));
+}
+
+// Position pos of leaf l, which may be one past its last value.
+template <typename T, int64_t B>
+typename b_tree<T,B>::iterator b_tree<T,B>::at(leaf* l, int64_t pos) const {
+    if (pos == l->count) {
+        l = l->next;
+        pos = 0;
+    }
+
+    return iterator(l, pos, &this->tail);
+}
+
+template <typename T, int64_t B>
+typename b_tree<T,B>::iterator b_tree<T,B>::lower_bound(T value) const {
+    if (this->tree_root == nullptr)
+        return this->end();
+
+    leaf* l = this->descend(value, nullptr);
+
+    return this->at(l, lower(l->items(), l->count, value));
+}
+
+// Descends past every separator not greater than value, since the values
+// left of such a separator are not greater than it either.
+template <typename T, int64_t B>
+typename b_tree<T,B>::iterator b_tree<T,B>::upper_bound(T value) const {
+    if (this->tree_root == nullptr)
+        return this->end();
+
+    node* n = this->tree_root;
+
+    for (int64_t level = this->height; level > 0; level--) {
+        branch* b = static_cast<branch*>(n);
+        n = b->children[upper(b->keys(), b->count, value)];
+    }
+
+    leaf* l = static_cast<leaf*>(n);
+
+    return this->at(l, upper(l->items(), l->count, value));
+}
+
+// The run of values neither less nor greater than value.
+template <typename T, int64_t B>
+std::pair<typename b_tree<T,B>::iterator, typename b_tree<T,B>::iterator>
+b_tree<T,B>::equal_range(T value) const {
+    return std::make_pair(this->lower_bound(value), this->upper_bound(value));
+}
+
+// The last value not greater than value, or null.
+template <typename T, int64_t B> T* b_tree<T,B>::floor(T value) const {
+    iterator it = this->upper_bound(value);
+
+    if (it == this->begin())
+        return nullptr;
+
+    --it;
+
+    return &it.l->item(it.pos);
+}
+
+// The first value not less than value, or null.
+template <typename T, int64_t B> T* b_tree<T,B>::ceiling(T value) const {
+    iterator it = this->lower_bound(value);
+
+    return (it == this->end() ? nullptr : &it.l->item(it.pos));
+}
+
+// Calls fn on every value in [lo, hi), in order, reading each leaf's
+// values straight from its array; O(log n + k) for k values.
+template <typename T, int64_t B> template <typename F>
+void b_tree<T,B>::for_each_in_range(T lo, T hi, F fn) const {
+    iterator it = this->lower_bound(lo);
+
+    for (leaf* l = it.l; l != nullptr; l = l->next) {
+        for (int64_t k = (l == it.l ? it.pos : 0); k < l->count; k++) {
+            if (!(l->item(k) < hi))
+                return;
+
+            fn(static_cast<const T&>(l->item(k)));
+        }
+    }
+}
+
+template <typename T, int64_t B> int64_t b_tree<T,B>::size() const { return this->s; }
+
+// Number of branch levels above the leaves.
+template <typename T, int64_t B> int64_t b_tree<T,B>::depth() const { return this->height; }
+
+// Only values that need destroying are visited; the slabs themselves
+// are released in one sweep.
+template <typename T, int64_t B> void b_tree<T,B>::clear() {
+    if (!std::is_trivially_destructible<T>::value && this->tree_root != nullptr)
+        this->destroy(this->tree_root, this->height);
+
+    this->leaves.release_all();
+    this->branches.release_all();
+
+    this->tree_root = this->head = this->tail = nullptr;
+    this->s = this->height = 0;
+}
+
+template <typename T, int64_t B> void b_tree<T,B>::swap(b_tree& other) {
+    std::swap(this->s, other.s);
+    std::swap(this->height, other.height);
+    std::swap(this->tree_root, other.tree_root);
+    std::swap(this->head, other.head);
+    std::swap(this->tail, other.tail);
+    this->leaves.swap(other.leaves);
+    this->branches.swap(other.branches);
+}
+
+template <typename T, int64_t B> typename b_tree<T,B>::iterator b_tree<T,B>::begin() const {
+    return iterator(this->head, 0, &this->tail);
+}
+
+template <typename T, int64_t B> typename b_tree<T,B>::iterator b_tree<T,B>::end() const {
+    return iterator(nullptr, 0, &this->tail);
+}
+
+template <typename T, int64_t B>
+typename b_tree<T,B>::const_iterator b_tree<T,B>::cbegin() const { return this->begin(); }
+
+template <typename T, int64_t B>
+typename b_tree<T,B>::const_iterator b_tree<T,B>::cend() const { return this->end(); }
+
+template <typename T, int64_t B>
+typename b_tree<T,B>::reverse_iterator b_tree<T,B>::rbegin() const {
+    return reverse_iterator(this->end());
+}
+
+template <typename T, int64_t B>
+typename b_tree<T,B>::reverse_iterator b_tree<T,B>::rend() const {
+    return reverse_iterator(this->begin());
+}
+
+template <typename T, int64_t B> std::ostream& operator<<(std::ostream& out, const b_tree<T,B>& tree) {
+    for (const T& value : tree) {
+        out << "[" << value << "]";
+    }
+
+    return out;
+}
+
+template <typename T, int64_t B> std::ostream& operator<<(std::ostream& out, const b_tree<T,B>* tree) {
+    return out << *tree;
+}
+
+#endif
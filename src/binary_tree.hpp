@@ -5,6 +5,7 @@
 #include <iostream>
 #include <stdint.h>
 #include "deque.hpp"
+#include "stack.hpp"
 #include "tree_node.hpp"
 #include "MACROS.hpp"
 
@@ -166,14 +167,34 @@ template <typename T> int64_t binary_tree<T>::size() const {
     return this->tree_size;
 }
 
+// Sets the depth of every node below node from node's own depth and
+// returns the deepest, or -1 for an empty subtree. Iterative, so that a
+// degenerate tree cannot overflow the call stack.
 template <typename T> int64_t max_depth(tree_node<T>* node) {
     if (node == nullptr) return -1;
-    if (node != nullptr && node->children() == 0) return node->depth();
 
-    if (node->right() != nullptr) node->right()->depth(node->depth()+1);
-    if (node->left() != nullptr) node->left()->depth(node->depth()+1);
+    int64_t deepest = node->depth();
+    stack<tree_node<T>*> pending;
 
-    return MAX(max_depth(node->right()), max_depth(node->left()));
+    pending.push(node);
+
+    while (!pending.is_empty()) {
+        tree_node<T>* current = pending.pop();
+
+        deepest = MAX(deepest, current->depth());
+
+        if (current->right() != nullptr) {
+            current->right()->depth(current->depth()+1);
+            pending.push(current->right());
+        }
+
+        if (current->left() != nullptr) {
+            current->left()->depth(current->depth()+1);
+            pending.push(current->left());
+        }
+    }
+
+    return deepest;
 }
 
 template <typename T> int64_t binary_tree<T>::depth() const {
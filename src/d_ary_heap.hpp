@@ -0,0 +1,274 @@
+#ifndef D_ARY_HEAP_H
+#define D_ARY_HEAP_H
+
+#pragma once
+#include <assert.h>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+
+// Implicit heap in which every node has up to D children. The order is
+// given by Compare: compare(a, b) is true when a belongs above b, so
+// std::greater<T> gives a max heap and std::less<T> a min heap.
+//
+// The children of node i are D*i+1 ... D*i+D. The root is stored at
+// slot D-1 of a cache-line aligned buffer, which puts every group of
+// siblings at a multiple of D; when D*sizeof(T) is 64 (D = 8 for 8 byte
+// keys, D = 4 for 16 byte keys) each sift-down step touches one line.
+template <typename T, int64_t D = 4, typename Compare = std::greater<T>> class d_ary_heap {
+    static_assert(D >= 2, "A d-ary heap needs at least two children per node");
+
+    private:
+        static constexpr int64_t offset = D-1;
+        static constexpr std::size_t alignment = 64;
+
+        int64_t s, cap;
+        T* slots;
+        Compare compare;
+
+        T& at(int64_t index) const { return this->slots[index + offset]; }
+
+        void reallocate(int64_t new_capacity);
+        void upheap(int64_t index);
+        void downheap(int64_t index = 0);
+    public:
+        d_ary_heap(Compare compare = Compare());
+        d_ary_heap(const d_ary_heap& copy);
+        d_ary_heap(d_ary_heap&& other);
+
+        ~d_ary_heap();
+
+        d_ary_heap& operator=(d_ary_heap copy);
+
+        void insert(T value);
+
+        T push_pop(T value);
+
+        T pop();
+        T root() const;
+        int64_t search(T value) const;
+        void reserve(int64_t capacity);
+        void clear();
+        void swap(d_ary_heap& other);
+
+        int64_t size() const;
+        int64_t depth() const;
+        bool is_empty() const;
+
+        template <typename U, int64_t E, typename C>
+        friend std::ostream& operator<<(std::ostream& out, const d_ary_heap<U,E,C>& heap);
+};
+
+template <typename T, int64_t D = 4> using d_ary_max_heap = d_ary_heap<T, D, std::greater<T>>;
+template <typename T, int64_t D = 4> using d_ary_min_heap = d_ary_heap<T, D, std::less<T>>;
+
+template <typename T, int64_t D, typename Compare>
+void d_ary_heap<T,D,Compare>::reallocate(int64_t new_capacity) {
+    T* new_slots = static_cast<T*>(::operator new(sizeof(T) * (new_capacity + offset),
+                                                  std::align_val_t(alignment)));
+
+    for (int64_t k = 0; k < this->s; k++) {
+        new (new_slots + k + offset) T(std::move(this->at(k)));
+        this->at(k).~T();
+    }
+
+    if (this->slots != nullptr)
+        ::operator delete(this->slots, std::align_val_t(alignment));
+
+    this->slots = new_slots;
+    this->cap = new_capacity;
+}
+
+template <typename T, int64_t D, typename Compare>
+void d_ary_heap<T,D,Compare>::upheap(int64_t index) {
+    T value = std::move(this->at(index));
+
+    while (index > 0) {
+        int64_t parent = (index-1)/D;
+
+        if (!this->compare(value, this->at(parent))) break;
+
+        this->at(index) = std::move(this->at(parent));
+        index = parent;
+    }
+
+    this->at(index) = std::move(value);
+}
+
+template <typename T, int64_t D, typename Compare>
+void d_ary_heap<T,D,Compare>::downheap(int64_t index) {
+    T value = std::move(this->at(index));
+
+    while (true) {
+        int64_t first = D*index + 1;
+
+        if (first >= this->s) break;
+
+        int64_t last = (first + D < this->s ? first + D : this->s),
+                best = first;
+
+        for (int64_t child = first+1; child < last; child++) {
+            if (this->compare(this->at(child), this->at(best))) best = child;
+        }
+
+        if (!this->compare(this->at(best), value)) break;
+
+        this->at(index) = std::move(this->at(best));
+        index = best;
+    }
+
+    this->at(index) = std::move(value);
+}
+
+template <typename T, int64_t D, typename Compare>
+d_ary_heap<T,D,Compare>::d_ary_heap(Compare compare) : s(0), cap(0), slots(nullptr),
+                                                       compare(compare) {}
+
+template <typename T, int64_t D, typename Compare>
+d_ary_heap<T,D,Compare>::d_ary_heap(const d_ary_heap& copy) : s(0), cap(0), slots(nullptr),
+                                                              compare(copy.compare) {
+    this->reserve(copy.size());
+
+    for (int64_t k = 0; k < copy.size(); k++) {
+        new (&this->at(k)) T(copy.at(k));
+    }
+
+    this->s = copy.size();
+}
+
+template <typename T, int64_t D, typename Compare>
+d_ary_heap<T,D,Compare>::d_ary_heap(d_ary_heap&& other) : s(0), cap(0), slots(nullptr),
+                                                          compare(other.compare) {
+    this->swap(other);
+}
+
+template <typename T, int64_t D, typename Compare>
+d_ary_heap<T,D,Compare>::~d_ary_heap() {
+    this->clear();
+
+    if (this->slots != nullptr)
+        ::operator delete(this->slots, std::align_val_t(alignment));
+}
+
+template <typename T, int64_t D, typename Compare>
+d_ary_heap<T,D,Compare>& d_ary_heap<T,D,Compare>::operator=(d_ary_heap copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T, int64_t D, typename Compare>
+void d_ary_heap<T,D,Compare>::insert(T value) {
+    if (this->s == this->cap)
+        this->reallocate(this->cap == 0 ? 8*D : this->cap * 2);
+
+    new (&this->at(this->s)) T(std::move(value));
+    this->upheap(this->s++);
+}
+
+// Equivalent to an insert followed by a pop, but with a single sift.
+template <typename T, int64_t D, typename Compare>
+T d_ary_heap<T,D,Compare>::push_pop(T value) {
+    if (this->is_empty() || !this->compare(this->at(0), value)) {
+        return value;
+    }
+
+    T top = std::move(this->at(0));
+    this->at(0) = std::move(value);
+    this->downheap();
+
+    return top;
+}
+
+template <typename T, int64_t D, typename Compare>
+T d_ary_heap<T,D,Compare>::pop() {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    T top = std::move(this->at(0));
+
+    if (--this->s > 0) {
+        this->at(0) = std::move(this->at(this->s));
+        this->downheap();
+    }
+
+    this->at(this->s).~T();
+
+    return top;
+}
+
+template <typename T, int64_t D, typename Compare>
+T d_ary_heap<T,D,Compare>::root() const {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    return this->at(0);
+}
+
+// Returns the level order index of the value, or -1 if it is not in the heap.
+template <typename T, int64_t D, typename Compare>
+int64_t d_ary_heap<T,D,Compare>::search(T value) const {
+    for (int64_t k = 0; k < this->s; k++) {
+        if (this->at(k) == value) return k;
+    }
+
+    return -1;
+}
+
+template <typename T, int64_t D, typename Compare>
+void d_ary_heap<T,D,Compare>::reserve(int64_t capacity) {
+    if (capacity > this->cap)
+        this->reallocate(capacity);
+}
+
+template <typename T, int64_t D, typename Compare>
+void d_ary_heap<T,D,Compare>::clear() {
+    while (this->s > 0) {
+        this->at(--this->s).~T();
+    }
+}
+
+template <typename T, int64_t D, typename Compare>
+void d_ary_heap<T,D,Compare>::swap(d_ary_heap& other) {
+    std::swap(this->s, other.s);
+    std::swap(this->cap, other.cap);
+    std::swap(this->slots, other.slots);
+    std::swap(this->compare, other.compare);
+}
+
+template <typename T, int64_t D, typename Compare>
+int64_t d_ary_heap<T,D,Compare>::size() const { return this->s; }
+
+template <typename T, int64_t D, typename Compare>
+int64_t d_ary_heap<T,D,Compare>::depth() const {
+    int64_t levels = 0, level_size = 1, covered = 0;
+
+    while (covered < this->s) {
+        covered += level_size;
+        level_size *= D;
+        ++levels;
+    }
+
+    return levels;
+}
+
+template <typename T, int64_t D, typename Compare>
+bool d_ary_heap<T,D,Compare>::is_empty() const { return (this->s == 0); }
+
+template <typename T, int64_t D, typename Compare>
+std::ostream& operator<<(std::ostream& out, const d_ary_heap<T,D,Compare>& heap) {
+    for (int64_t k = 0; k < heap.size(); k++) {
+        out << "<" << heap.at(k) << ">";
+    }
+
+    return out;
+}
+
+template <typename T, int64_t D, typename Compare>
+std::ostream& operator<<(std::ostream& out, const d_ary_heap<T,D,Compare>* heap) {
+    return out << *heap;
+}
+
+#endif
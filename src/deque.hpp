@@ -2,9 +2,210 @@
 #define DEQUE_H
 
 #pragma once
-#include "list.hpp"
+#include <assert.h>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
 
-// FIFO Data Structure
-template <typename T> class deque : public list<T> {};
+// Double-ended queue in a circular buffer. The capacity is a power of two
+// so positions wrap with a mask; when the buffer is full it doubles and
+// the elements are moved to the front of the new one. Pushes and pops at
+// either end are O(1) amortized, indexing is O(1), and no memory is
+// allocated per element.
+template <typename T> class deque {
+    private:
+        int64_t s, cap, first;
+        T* buffer;
+
+        T* slot(int64_t idx) const;
+        void reallocate(int64_t new_capacity);
+    public:
+        deque() : s(0), cap(0), first(0), buffer(nullptr) {}
+        deque(const deque<T>& copy);
+        deque(deque<T>&& other);
+
+        ~deque();
+
+        deque<T>& operator=(deque<T> copy);
+
+        void push_back(T value);
+        void push_front(T value);
+
+        T pop_front();
+        T pop_back();
+
+        void reserve(int64_t new_capacity);
+        void clear();
+        void swap(deque<T>& other);
+
+        int64_t size() const;
+        int64_t capacity() const;
+        bool is_empty() const;
+
+        T& front();
+        T& back();
+
+        T& operator[](int64_t idx);
+        const T& operator[](int64_t idx) const;
+
+        template <typename U>
+        friend std::ostream& operator<<(std::ostream& out, const deque<U>& d);
+};
+
+template <typename T> T* deque<T>::slot(int64_t idx) const {
+    return this->buffer + ((this->first + idx) & (this->cap - 1));
+}
+
+template <typename T> void deque<T>::reallocate(int64_t new_capacity) {
+    T* new_buffer = static_cast<T*>(::operator new(sizeof(T) * new_capacity));
+
+    for (int64_t k = 0; k < this->s; k++) {
+        T* old = this->slot(k);
+
+        new (new_buffer + k) T(std::move(*old));
+        old->~T();
+    }
+
+    ::operator delete(this->buffer);
+
+    this->buffer = new_buffer;
+    this->cap = new_capacity;
+    this->first = 0;
+}
+
+template <typename T> deque<T>::deque(const deque<T>& copy) : deque() {
+    this->reserve(copy.size());
+
+    for (int64_t k = 0; k < copy.size(); k++) {
+        new (this->buffer + k) T(copy[k]);
+    }
+
+    this->s = copy.size();
+}
+
+template <typename T> deque<T>::deque(deque<T>&& other) : deque() {
+    this->swap(other);
+}
+
+template <typename T> deque<T>::~deque() {
+    this->clear();
+    ::operator delete(this->buffer);
+}
+
+template <typename T> deque<T>& deque<T>::operator=(deque<T> copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T> void deque<T>::push_back(T value) {
+    if (this->s == this->cap) {
+        this->reallocate(this->cap == 0 ? 16 : this->cap * 2);
+    }
+
+    new (this->slot(this->s++)) T(std::move(value));
+}
+
+template <typename T> void deque<T>::push_front(T value) {
+    if (this->s == this->cap) {
+        this->reallocate(this->cap == 0 ? 16 : this->cap * 2);
+    }
+
+    this->first = (this->first - 1) & (this->cap - 1);
+    ++this->s;
+
+    new (this->buffer + this->first) T(std::move(value));
+}
+
+template <typename T> T deque<T>::pop_front() {
+    if (this->is_empty())
+        throw std::out_of_range("The deque is empty");
+
+    T* front = this->buffer + this->first;
+    T value = std::move(*front);
+    front->~T();
+
+    this->first = (this->first + 1) & (this->cap - 1);
+    --this->s;
+
+    return value;
+}
+
+template <typename T> T deque<T>::pop_back() {
+    if (this->is_empty())
+        throw std::out_of_range("The deque is empty");
+
+    T* back = this->slot(--this->s);
+    T value = std::move(*back);
+    back->~T();
+
+    return value;
+}
+
+// Rounds the capacity up to the next power of two.
+template <typename T> void deque<T>::reserve(int64_t new_capacity) {
+    if (new_capacity <= this->cap)
+        return;
+
+    int64_t capacity = 16;
+
+    while (capacity < new_capacity) capacity *= 2;
+
+    this->reallocate(capacity);
+}
+
+template <typename T> void deque<T>::clear() {
+    while (this->s > 0) {
+        this->slot(--this->s)->~T();
+    }
+
+    this->first = 0;
+}
+
+template <typename T> void deque<T>::swap(deque<T>& other) {
+    std::swap(this->s, other.s);
+    std::swap(this->cap, other.cap);
+    std::swap(this->first, other.first);
+    std::swap(this->buffer, other.buffer);
+}
+
+template <typename T> int64_t deque<T>::size() const { return this->s; }
+
+template <typename T> int64_t deque<T>::capacity() const { return this->cap; }
+
+template <typename T> bool deque<T>::is_empty() const { return (this->s == 0); }
+
+template <typename T> T& deque<T>::front() {
+    assert(this->s > 0);
+    return *this->slot(0);
+}
+
+template <typename T> T& deque<T>::back() {
+    assert(this->s > 0);
+    return *this->slot(this->s-1);
+}
+
+template <typename T> T& deque<T>::operator[](int64_t idx) {
+    assert(idx >= 0 && idx < this->s);
+    return *this->slot(idx);
+}
+
+template <typename T> const T& deque<T>::operator[](int64_t idx) const {
+    assert(idx >= 0 && idx < this->s);
+    return *this->slot(idx);
+}
+
+template <typename T> std::ostream& operator<<(std::ostream& out, const deque<T>& d) {
+    for (int64_t k = 0; k < d.size(); k++) {
+        out << "[" << d[k] << "]";
+    }
+
+    return out;
+}
+
+template <typename T> std::ostream& operator<<(std::ostream& out, const deque<T>* d) {
+    return out << *d;
+}
 
 #endif
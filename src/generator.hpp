@@ -0,0 +1,97 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+// Sequence of const T& produced lazily by a coroutine that co_yields
+// values it keeps alive, such as the values stored in a tree. Only the
+// address of each value is held, so nothing is copied. Single pass: the
+// sequence is consumed by iterating it, as with an input iterator.
+template <typename T> class generator {
+    public:
+        struct promise_type;
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    public:
+        struct promise_type {
+            const T* current = nullptr;
+            std::exception_ptr error;
+
+            generator get_return_object() {
+                return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            std::suspend_always yield_value(const T& value) noexcept {
+                this->current = &value;
+                return {};
+            }
+
+            void return_void() noexcept {}
+            void unhandled_exception() { this->error = std::current_exception(); }
+        };
+
+        class iterator {
+            private:
+                std::coroutine_handle<promise_type> handle;
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const T* pointer;
+                typedef const T& reference;
+
+                iterator(std::coroutine_handle<promise_type> handle = nullptr) : handle(handle) {}
+
+                reference operator*() const { return *this->handle.promise().current; }
+                pointer operator->() const { return this->handle.promise().current; }
+
+                // Runs the coroutine on to its next co_yield.
+                iterator& operator++() {
+                    this->handle.resume();
+
+                    if (this->handle.done() && this->handle.promise().error)
+                        std::rethrow_exception(this->handle.promise().error);
+
+                    return *this;
+                }
+
+                void operator++(int) { ++*this; }
+
+                friend bool operator==(const iterator& it, std::default_sentinel_t) { return it.handle.done(); }
+                friend bool operator!=(const iterator& it, std::default_sentinel_t) { return !it.handle.done(); }
+        };
+
+        generator(const generator& copy) = delete;
+        generator(generator&& other) : handle(std::exchange(other.handle, nullptr)) {}
+
+        ~generator() {
+            if (this->handle) this->handle.destroy();
+        }
+
+        generator& operator=(const generator& copy) = delete;
+
+        // Starts the coroutine, so it is called once.
+        iterator begin() {
+            iterator it(this->handle);
+            ++it;
+
+            return it;
+        }
+
+        std::default_sentinel_t end() const { return std::default_sentinel; }
+};
+#endif
+
+#endif
@@ -3,39 +3,44 @@
 
 #pragma once
 #include <assert.h>
-#include "deque.hpp"
 #include "list.hpp"
-#include "tree_node.hpp"
+#include "vector.hpp"
+#include "MACROS.hpp"
 
-// In a max heap, for any given node C, if P is 
-// a parent node of C, then the key (value) of P 
+// In a max heap, for any given node C, if P is
+// a parent node of C, then the key (value) of P
 // is greater than the key (value) of C: P > C
 
-// This structure implements a binary heap
+// This structure implements an implicit binary heap: the tree is
+// stored level by level in a contiguous array, so the children of
+// the node at index i live at 2i+1 and 2i+2, and its parent at (i-1)/2.
 template <typename T> class max_heap {
     private:
-        int64_t heap_size;
-        tree_node<T>* heap_root;
+        vector<T> heap_array;
 
-        void downheap();
-        tree_node<T>* navigate(list<bool> navigation) const;
-        tree_node<T>* node_at_index(int64_t index) const;
+        void upheap(int64_t index);
+        void downheap(int64_t index = 0);
+        void heapify();
     public:
-        heap(tree_node<T>* root = nullptr);
+        max_heap() {}
 
-        heap(list<T> init);
+        max_heap(const list<T>& init);
 
-        ~heap() {};
+        template <typename Iterator>
+        max_heap(Iterator first, Iterator last);
+
+        ~max_heap() {};
 
         void insert(T value);
-        void insert(tree_node<T>* node);
 
         T push_pop(T value);
-        T push_pop(tree_node<T>* node);
+
+        void merge(max_heap<T>&& other);
 
         T pop();
-        tree_node<T>* root() const;
-        tree_node<T>* search(T value) const;
+        T root() const;
+        int64_t search(T value) const;
+        void reserve(int64_t capacity);
         void clear();
 
         int64_t size() const;
@@ -43,178 +48,176 @@ template <typename T> class max_heap {
         bool is_empty() const;
 
         template <typename U>
-        friend std::ostream& operator<<(std::ostream& out, heap<U>& heap);
+        friend std::ostream& operator<<(std::ostream& out, const max_heap<U>& heap);
 };
 
-template <typename T> void heap<T>::downheap() {
-    tree_node<T>* current = this->heap_root;
-
-    while (current != nullptr) {
-        bool right = (current->right() == nullptr || 
-                      current->value() > current->right()->value());
-
-        bool left = (current->left() == nullptr ||
-                     current->value() > current->left()->value());
+template <typename T> void max_heap<T>::upheap(int64_t index) {
+    T value = this->heap_array[index];
 
-        if (left && right) break;
+    // Shift smaller parents down instead of swapping at every level.
+    while (index > 0) {
+        int64_t parent = (index-1)/2;
 
-        bool rgtl = (current->right()->value() >= current->left()->value());
+        if (!(value > this->heap_array[parent])) break;
 
-        if (rgtl) {
-            swap(current, current->right());
-            current = current->right();
-        } else {
-            swap(current, current->left());
-            current = current->left();
-        }
+        this->heap_array[index] = this->heap_array[parent];
+        index = parent;
     }
+
+    this->heap_array[index] = value;
 }
 
-template <typename T> tree_node<T>* heap<T>::navigate(list<bool> navigation) const {
-    tree_node<T>* current = this->heap_root;
-    navigation.pop_front();
+template <typename T> void max_heap<T>::downheap(int64_t index) {
+    int64_t n = this->heap_array.size();
+    T value = this->heap_array[index];
 
-    while (!navigation.is_empty()) {
-        current = (navigation.pop_front() ? current->right() : current->left());
-    }
+    while (true) {
+        int64_t child = 2*index + 1;
 
-    return current;
-}
+        if (child >= n) break;
 
-template <typename T> tree_node<T>* heap<T>::node_at_index(int64_t index) const {
-    tree_node<T>* current = this->heap_root;
+        if (child+1 < n && this->heap_array[child+1] > this->heap_array[child])
+            ++child;
 
-    list<bool> bin = dec_to_bin(++index);
+        if (!(this->heap_array[child] > value)) break;
 
-    return this->navigate(bin);
-}
+        this->heap_array[index] = this->heap_array[child];
+        index = child;
+    }
 
-template <typename T> heap<T>::heap(tree_node<T>* root) : heap_root(root) {
-    this->heap_size = 0;
-    if (this->heap_root != nullptr) this->heap_size++;
+    this->heap_array[index] = value;
 }
 
-template <typename T> heap<T>::heap(list<T> init) {
-    for (int64_t i = 0; i < init.size(); i++) {
-        this->insert(init[i]);
+// Floyd's bottom-up construction: every subtree below index n/2 is a
+// single leaf, so sifting the internal nodes down from the last one
+// upwards costs O(n) in total.
+template <typename T> void max_heap<T>::heapify() {
+    for (int64_t k = this->heap_array.size()/2 - 1; k >= 0; k--) {
+        this->downheap(k);
     }
 }
 
-template <typename T> void heap<T>::insert(tree_node<T>* node) {
-    ++this->heap_size;
-    if (this->heap_root == nullptr) this->heap_root = node;
-    else {
-        list<bool> navigation = dec_to_bin(this->heap_size);
-        bool R = navigation.pop_back();
-
-        tree_node<T>* parent_node = this->navigate(navigation);
+template <typename T> max_heap<T>::max_heap(const list<T>& init) {
+    this->heap_array.reserve(init.size());
 
-        if (R) parent_node->right(node);
-        else parent_node->left(node);
+    for (linked_node<T>* current = init.front(); current != nullptr; current = current->next()) {
+        this->heap_array.push_back(current->value());
+    }
 
-        tree_node<T>* current = node;
+    this->heapify();
+}
 
-        while (current->parent() != nullptr) {
-            if (current->value() > current->parent()->value()) {
-                swap(current, current->parent());
-            }
-            current = current->parent();
-        }
+template <typename T> template <typename Iterator>
+max_heap<T>::max_heap(Iterator first, Iterator last) {
+    for (; first != last; ++first) {
+        this->heap_array.push_back(*first);
     }
+
+    this->heapify();
 }
 
-template <typename T> void heap<T>::insert(T value) {
-    tree_node<T>* node = new tree_node<T>(value);
-    this->insert(node);
+template <typename T> void max_heap<T>::insert(T value) {
+    this->heap_array.push_back(value);
+    this->upheap(this->heap_array.size()-1);
 }
 
-template <typename T> T heap<T>::push_pop(tree_node<T>* node) {
-    if (this->heap_root == nullptr || (node->value() >= this->heap_root->value())) {
-        return node->value(); 
+// Equivalent to an insert followed by a pop, but with a single sift.
+template <typename T> T max_heap<T>::push_pop(T value) {
+    if (this->is_empty() || !(this->heap_array[0] > value)) {
+        return value;
     }
 
-    T value = this->heap_root->value();
-    this->heap_root->value(node->value());
+    T top = this->heap_array[0];
+    this->heap_array[0] = value;
     this->downheap();
 
-    return value;
-}
-
-template <typename T> T heap<T>::push_pop(T value) {
-    tree_node<T>* node = new tree_node<T>(value);
-
-    return this->push_pop(node);
+    return top;
 }
 
-template <typename T> T heap<T>::pop() {
-    if (this->root == nullptr) return static_cast<T>(0);
-
-    tree_node<T>* last_node = this->node_at_index(this->heap_size-1);
+// Appends the other heap's array to this one. A small heap is sifted up
+// element by element; otherwise the whole array is rebuilt in O(n + m).
+template <typename T> void max_heap<T>::merge(max_heap<T>&& other) {
+    int64_t n = this->size(), m = other.size();
 
-    T value = this->heap_root->value();
-
-    swap(this->heap_root, last_node);
+    if (n == 0) {
+        this->heap_array.swap(other.heap_array);
+        return;
+    }
 
-    this->last_node->isolate();
+    this->heap_array.reserve(n + m);
 
-    this->downheap();
+    for (int64_t k = 0; k < m; k++) {
+        this->heap_array.push_back(other.heap_array[k]);
+    }
 
-    return value;
-}
+    other.clear();
 
-template <typename T> tree_node<T>* heap<T>::root() const {
-    return this->heap_root;
+    if (m * log2(n + m) < n + m) {
+        for (int64_t k = n; k < n + m; k++) this->upheap(k);
+    } else {
+        this->heapify();
+    }
 }
 
-template <typename T> tree_node<T>* heap<T>::search(T value) const {
-    deque<tree_node<T>*> q;
+template <typename T> T max_heap<T>::pop() {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
 
-    if (this->heap_root != nullptr) q.push_back(this->heap_root);
+    T top = this->heap_array[0];
+    T last = this->heap_array.pop_back();
 
-    while (!q.empty()) {
-        tree_node<T>* node = q.pop_front();
-
-        if (node->value() == value) return node;
-
-        if (node->right() != nullptr) q.push_back(node->right());
-        if (node->left() != nullptr) q.push_back(node->left());
+    if (!this->is_empty()) {
+        this->heap_array[0] = last;
+        this->downheap();
     }
 
-    return nullptr;
+    return top;
 }
 
-template <typename T> void heap<T>::clear() {
-    this->heap_root = nullptr;
+template <typename T> T max_heap<T>::root() const {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    return this->heap_array[0];
 }
 
-template <typename T> int64_t heap<T>::size() const { return this->heap_size; }
+// Returns the array index of the value, or -1 if it is not in the heap.
+template <typename T> int64_t max_heap<T>::search(T value) const {
+    for (int64_t k = 0; k < this->heap_array.size(); k++) {
+        if (this->heap_array[k] == value) return k;
+    }
 
-template <typename T> int64_t heap<T>::depth() const {
-    return log2(this->heap_size) + 1;
+    return -1;
 }
 
-template <typename T> bool heap<T>::is_empty() const {
-    return (this->heap_root == nullptr);
+template <typename T> void max_heap<T>::reserve(int64_t capacity) {
+    this->heap_array.reserve(capacity);
 }
 
-template <typename T> std::ostream& operator<<(std::ostream& out, heap<T>& heap) {
-    deque<tree_node<T>*> q;
+template <typename T> void max_heap<T>::clear() {
+    this->heap_array.clear();
+}
 
-    if (heap.heap_root != nullptr) q.push_back(heap.heap_root);
+template <typename T> int64_t max_heap<T>::size() const { return this->heap_array.size(); }
 
-    while (!q.is_empty()) {
-        tree_node<T>* node = q.pop_front();
+template <typename T> int64_t max_heap<T>::depth() const {
+    return (this->is_empty() ? 0 : log2(this->size()) + 1);
+}
 
-        out << *node;
+template <typename T> bool max_heap<T>::is_empty() const {
+    return this->heap_array.is_empty();
+}
 
-        if (node->left() != nullptr) q.push_back(node->left());
-        if (node->right() != nullptr) q.push_back(node->right());
+// The array is already in level order.
+template <typename T> std::ostream& operator<<(std::ostream& out, const max_heap<T>& heap) {
+    for (int64_t k = 0; k < heap.size(); k++) {
+        out << "<" << heap.heap_array[k] << ">";
     }
 
     return out;
 }
 
-template <typename T> std::ostream& operator<<(std::ostream& out, const heap<T>* heap) {
+template <typename T> std::ostream& operator<<(std::ostream& out, const max_heap<T>* heap) {
     return out << *heap;
 }
 
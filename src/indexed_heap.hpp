@@ -0,0 +1,251 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#pragma once
+#include <assert.h>
+#include <functional>
+#include <stdexcept>
+#include "vector.hpp"
+#include "MACROS.hpp"
+
+// Addressable binary heap. insert() hands back a handle that stays valid
+// until the element is popped or erased, and every keyed operation takes
+// that handle, so no search is ever needed to find an element.
+//
+// Handles index a table recording each element's value and its current
+// slot in the heap array; the array itself only holds handles. Handles
+// of removed elements are recycled by later inserts.
+//
+// As in d_ary_heap, compare(a, b) is true when a belongs above b, so the
+// default is a max heap and std::less<T> gives the min heap Dijkstra uses.
+template <typename T, typename Compare = std::greater<T>> class indexed_heap {
+    public:
+        typedef int64_t handle;
+    private:
+        struct entry {
+            T value;
+            int64_t position;
+        };
+
+        vector<entry> entries;
+        vector<handle> heap_array;
+        vector<handle> free_handles;
+        Compare compare;
+
+        bool above(int64_t i, int64_t j) const;
+        void place(int64_t index, handle h);
+        void upheap(int64_t index);
+        void downheap(int64_t index);
+        void remove_at(int64_t index);
+    public:
+        indexed_heap(Compare compare = Compare()) : compare(compare) {}
+
+        ~indexed_heap() {}
+
+        handle insert(T value);
+
+        T pop();
+        T root() const;
+        handle root_handle() const;
+
+        T value(handle h) const;
+        bool contains(handle h) const;
+
+        void update(handle h, T value);
+        void decrease_key(handle h, T value);
+        void increase_key(handle h, T value);
+        void erase(handle h);
+
+        void reserve(int64_t capacity);
+        void clear();
+
+        int64_t size() const;
+        int64_t depth() const;
+        bool is_empty() const;
+};
+
+template <typename T, typename Compare>
+bool indexed_heap<T,Compare>::above(int64_t i, int64_t j) const {
+    return this->compare(this->entries[this->heap_array[i]].value,
+                         this->entries[this->heap_array[j]].value);
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::place(int64_t index, handle h) {
+    this->heap_array[index] = h;
+    this->entries[h].position = index;
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::upheap(int64_t index) {
+    handle h = this->heap_array[index];
+    const T& value = this->entries[h].value;
+
+    while (index > 0) {
+        int64_t parent = (index-1)/2;
+        handle p = this->heap_array[parent];
+
+        if (!this->compare(value, this->entries[p].value)) break;
+
+        this->place(index, p);
+        index = parent;
+    }
+
+    this->place(index, h);
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::downheap(int64_t index) {
+    int64_t n = this->heap_array.size();
+    handle h = this->heap_array[index];
+    const T& value = this->entries[h].value;
+
+    while (true) {
+        int64_t child = 2*index + 1;
+
+        if (child >= n) break;
+
+        if (child+1 < n && this->above(child+1, child))
+            ++child;
+
+        handle c = this->heap_array[child];
+
+        if (!this->compare(this->entries[c].value, value)) break;
+
+        this->place(index, c);
+        index = child;
+    }
+
+    this->place(index, h);
+}
+
+// Moves the last element into the vacated slot and restores the order
+// from there, in whichever direction the moved value needs to travel.
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::remove_at(int64_t index) {
+    handle removed = this->heap_array[index],
+           last = this->heap_array.pop_back();
+
+    this->entries[removed].position = -1;
+    this->free_handles.push_back(removed);
+
+    if (index == this->heap_array.size())
+        return;
+
+    this->place(index, last);
+
+    if (index > 0 && this->above(index, (index-1)/2)) this->upheap(index);
+    else this->downheap(index);
+}
+
+template <typename T, typename Compare>
+typename indexed_heap<T,Compare>::handle indexed_heap<T,Compare>::insert(T value) {
+    handle h;
+
+    if (!this->free_handles.is_empty()) {
+        h = this->free_handles.pop_back();
+        this->entries[h].value = value;
+    } else {
+        h = this->entries.size();
+        this->entries.push_back({ value, -1 });
+    }
+
+    this->heap_array.push_back(h);
+    this->entries[h].position = this->heap_array.size()-1;
+    this->upheap(this->heap_array.size()-1);
+
+    return h;
+}
+
+template <typename T, typename Compare>
+T indexed_heap<T,Compare>::pop() {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    T top = this->entries[this->heap_array[0]].value;
+    this->remove_at(0);
+
+    return top;
+}
+
+template <typename T, typename Compare>
+T indexed_heap<T,Compare>::root() const {
+    return this->value(this->root_handle());
+}
+
+template <typename T, typename Compare>
+typename indexed_heap<T,Compare>::handle indexed_heap<T,Compare>::root_handle() const {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    return this->heap_array[0];
+}
+
+template <typename T, typename Compare>
+T indexed_heap<T,Compare>::value(handle h) const {
+    assert(this->contains(h));
+    return this->entries[h].value;
+}
+
+template <typename T, typename Compare>
+bool indexed_heap<T,Compare>::contains(handle h) const {
+    return (h >= 0 && h < this->entries.size() && this->entries[h].position != -1);
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::update(handle h, T value) {
+    assert(this->contains(h));
+
+    bool rises = this->compare(value, this->entries[h].value);
+    this->entries[h].value = value;
+
+    if (rises) this->upheap(this->entries[h].position);
+    else this->downheap(this->entries[h].position);
+}
+
+// decrease_key takes a key no greater than the old one and increase_key
+// one no smaller, whichever way Compare orders the heap; in the min heap
+// Dijkstra uses, a shorter distance is a decrease_key.
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::decrease_key(handle h, T value) {
+    assert(this->contains(h) && !(this->entries[h].value < value));
+    this->update(h, value);
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::increase_key(handle h, T value) {
+    assert(this->contains(h) && !(value < this->entries[h].value));
+    this->update(h, value);
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::erase(handle h) {
+    assert(this->contains(h));
+    this->remove_at(this->entries[h].position);
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::reserve(int64_t capacity) {
+    this->entries.reserve(capacity);
+    this->heap_array.reserve(capacity);
+}
+
+template <typename T, typename Compare>
+void indexed_heap<T,Compare>::clear() {
+    this->entries.clear();
+    this->heap_array.clear();
+    this->free_handles.clear();
+}
+
+template <typename T, typename Compare>
+int64_t indexed_heap<T,Compare>::size() const { return this->heap_array.size(); }
+
+template <typename T, typename Compare>
+int64_t indexed_heap<T,Compare>::depth() const {
+    return (this->is_empty() ? 0 : log2(this->size()) + 1);
+}
+
+template <typename T, typename Compare>
+bool indexed_heap<T,Compare>::is_empty() const { return this->heap_array.is_empty(); }
+
+#endif
@@ -0,0 +1,322 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#pragma once
+#include "node.hpp"
+#include <assert.h>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+template <typename T> class intrusive_list;
+
+// Bidirectional iterator over the objects of an intrusive_list. R is T
+// for a mutable iterator and const T for a const one.
+template <typename T, typename R> class intrusive_list_iterator {
+    private:
+        T* node;
+        const intrusive_list<T>* owner;
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef R* pointer;
+        typedef R& reference;
+
+        intrusive_list_iterator(T* node = nullptr, const intrusive_list<T>* owner = nullptr) : node(node),
+                                                                                              owner(owner) {}
+
+        operator intrusive_list_iterator<T, const T>() const {
+            return intrusive_list_iterator<T, const T>(this->node, this->owner);
+        }
+
+        reference operator*() const { return *this->node; }
+        pointer operator->() const { return this->node; }
+
+        intrusive_list_iterator& operator++() {
+            this->node = this->node->next();
+            return *this;
+        }
+
+        intrusive_list_iterator operator++(int) {
+            intrusive_list_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        intrusive_list_iterator& operator--() {
+            this->node = (this->node == nullptr ? this->owner->back() : this->node->prev());
+            return *this;
+        }
+
+        intrusive_list_iterator operator--(int) {
+            intrusive_list_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        friend bool operator==(const intrusive_list_iterator& a, const intrusive_list_iterator& b) {
+            return a.node == b.node;
+        }
+
+        friend bool operator!=(const intrusive_list_iterator& a, const intrusive_list_iterator& b) {
+            return a.node != b.node;
+        }
+
+        T* node_ptr() const { return this->node; }
+};
+
+// Doubly linked list of objects that carry their own links: T derives
+// from list_hook<T>, the same link pair linked_node uses. Objects are
+// linked in place and never copied or allocated, so they can live in an
+// arena, on the stack or inside another container, and the list does
+// not own them. An object is in at most one list per hook at a time and
+// must stay alive, and in place, while it is linked.
+//
+// Every operation other than clear() and the walks is O(1); remove() and
+// the move_to_* calls only need a pointer to the object, which makes LRU
+// lists and wait queues allocation free.
+template <typename T> class intrusive_list {
+    private:
+        int64_t s;
+        T *head, *tail;
+
+        void unlink(T* node);
+    public:
+        typedef intrusive_list_iterator<T, T> iterator;
+        typedef intrusive_list_iterator<T, const T> const_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        intrusive_list() : s(0), head(nullptr), tail(nullptr) {
+            static_assert(std::is_base_of<list_hook<T>, T>::value, "T must derive from list_hook<T>");
+        }
+
+        intrusive_list(const intrusive_list<T>& copy) = delete;
+        intrusive_list(intrusive_list<T>&& other);
+
+        ~intrusive_list() { this->clear(); }
+
+        intrusive_list<T>& operator=(const intrusive_list<T>& copy) = delete;
+        intrusive_list<T>& operator=(intrusive_list<T>&& other);
+        void swap(intrusive_list<T>& other);
+
+        void push_front(T* node);
+        void push_back(T* node);
+        void insert_before(T* pos, T* node);
+
+        T* pop_front();
+        T* pop_back();
+        void remove(T* node);
+        void clear();
+
+        void move_to_front(T* node);
+        void move_to_back(T* node);
+
+        int64_t size() const;
+        bool is_empty() const;
+
+        T* front() const;
+        T* back() const;
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        reverse_iterator rbegin();
+        reverse_iterator rend();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator rend() const;
+};
+
+template <typename T> void intrusive_list<T>::unlink(T* node) {
+    T *before = node->prev(),
+      *after = node->next();
+
+    if (before != nullptr) before->next(after, false);
+    else this->head = after;
+
+    if (after != nullptr) after->prev(before, false);
+    else this->tail = before;
+
+    node->next(nullptr, false);
+    node->prev(nullptr, false);
+}
+
+template <typename T> intrusive_list<T>::intrusive_list(intrusive_list<T>&& other) : intrusive_list() {
+    this->swap(other);
+}
+
+template <typename T> intrusive_list<T>& intrusive_list<T>::operator=(intrusive_list<T>&& other) {
+    this->clear();
+    this->swap(other);
+    return *this;
+}
+
+template <typename T> void intrusive_list<T>::swap(intrusive_list<T>& other) {
+    std::swap(this->s, other.s);
+    std::swap(this->head, other.head);
+    std::swap(this->tail, other.tail);
+}
+
+template <typename T> void intrusive_list<T>::push_front(T* node) {
+    node->prev(nullptr, false);
+    node->next(this->head, false);
+
+    if (this->head != nullptr) this->head->prev(node, false);
+    else this->tail = node;
+
+    this->head = node;
+    ++this->s;
+}
+
+template <typename T> void intrusive_list<T>::push_back(T* node) {
+    node->next(nullptr, false);
+    node->prev(this->tail, false);
+
+    if (this->tail != nullptr) this->tail->next(node, false);
+    else this->head = node;
+
+    this->tail = node;
+    ++this->s;
+}
+
+// pos == nullptr appends the node.
+template <typename T> void intrusive_list<T>::insert_before(T* pos, T* node) {
+    if (pos == nullptr) {
+        this->push_back(node);
+        return;
+    }
+
+    if (pos == this->head) {
+        this->push_front(node);
+        return;
+    }
+
+    node->prev(pos->prev());
+    node->next(pos);
+    ++this->s;
+}
+
+template <typename T> T* intrusive_list<T>::pop_front() {
+    if (this->is_empty())
+        throw std::out_of_range("The intrusive list is empty");
+
+    T* node = this->head;
+
+    this->unlink(node);
+    --this->s;
+
+    return node;
+}
+
+template <typename T> T* intrusive_list<T>::pop_back() {
+    if (this->is_empty())
+        throw std::out_of_range("The intrusive list is empty");
+
+    T* node = this->tail;
+
+    this->unlink(node);
+    --this->s;
+
+    return node;
+}
+
+// The node must be linked into this list.
+template <typename T> void intrusive_list<T>::remove(T* node) {
+    assert(this->s > 0);
+
+    this->unlink(node);
+    --this->s;
+}
+
+// Unlinks every object so that each can be linked again elsewhere.
+template <typename T> void intrusive_list<T>::clear() {
+    T* node = this->head;
+
+    while (node != nullptr) {
+        T* next = node->next();
+
+        node->next(nullptr, false);
+        node->prev(nullptr, false);
+
+        node = next;
+    }
+
+    this->head = this->tail = nullptr;
+    this->s = 0;
+}
+
+template <typename T> void intrusive_list<T>::move_to_front(T* node) {
+    if (node == this->head)
+        return;
+
+    this->unlink(node);
+    --this->s;
+    this->push_front(node);
+}
+
+template <typename T> void intrusive_list<T>::move_to_back(T* node) {
+    if (node == this->tail)
+        return;
+
+    this->unlink(node);
+    --this->s;
+    this->push_back(node);
+}
+
+template <typename T> int64_t intrusive_list<T>::size() const { return this->s; }
+
+template <typename T> bool intrusive_list<T>::is_empty() const { return (this->head == nullptr); }
+
+template <typename T> T* intrusive_list<T>::front() const { return this->head; }
+
+template <typename T> T* intrusive_list<T>::back() const { return this->tail; }
+
+template <typename T> typename intrusive_list<T>::iterator intrusive_list<T>::begin() {
+    return iterator(this->head, this);
+}
+
+template <typename T> typename intrusive_list<T>::iterator intrusive_list<T>::end() {
+    return iterator(nullptr, this);
+}
+
+template <typename T> typename intrusive_list<T>::const_iterator intrusive_list<T>::begin() const {
+    return const_iterator(this->head, this);
+}
+
+template <typename T> typename intrusive_list<T>::const_iterator intrusive_list<T>::end() const {
+    return const_iterator(nullptr, this);
+}
+
+template <typename T> typename intrusive_list<T>::const_iterator intrusive_list<T>::cbegin() const {
+    return this->begin();
+}
+
+template <typename T> typename intrusive_list<T>::const_iterator intrusive_list<T>::cend() const {
+    return this->end();
+}
+
+template <typename T> typename intrusive_list<T>::reverse_iterator intrusive_list<T>::rbegin() {
+    return reverse_iterator(this->end());
+}
+
+template <typename T> typename intrusive_list<T>::reverse_iterator intrusive_list<T>::rend() {
+    return reverse_iterator(this->begin());
+}
+
+template <typename T> typename intrusive_list<T>::const_reverse_iterator intrusive_list<T>::rbegin() const {
+    return const_reverse_iterator(this->end());
+}
+
+template <typename T> typename intrusive_list<T>::const_reverse_iterator intrusive_list<T>::rend() const {
+    return const_reverse_iterator(this->begin());
+}
+
+#endif
@@ -3,22 +3,102 @@
 
 #pragma once
 #include "node.hpp"
+#include "pool.hpp"
 #include <assert.h>
+#include <cstddef>
+#include <iterator>
 #include <stdint.h>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
+template <typename T> class list;
+
+// Bidirectional iterator over a list's nodes. R is T for a mutable
+// iterator and const T for a const one. The end position is a null node;
+// the list is remembered so that decrementing end() reaches the tail.
+template <typename T, typename R> class list_iterator {
+    private:
+        linked_node<T>* node;
+        const list<T>* owner;
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef R* pointer;
+        typedef R& reference;
+
+        list_iterator(linked_node<T>* node = nullptr, const list<T>* owner = nullptr) : node(node),
+                                                                                       owner(owner) {}
+
+        // Lets an iterator be passed where a const_iterator is expected.
+        operator list_iterator<T, const T>() const { return list_iterator<T, const T>(this->node, this->owner); }
+
+        reference operator*() const { return this->node->value_ref(); }
+        pointer operator->() const { return &this->node->value_ref(); }
+
+        list_iterator& operator++() {
+            this->node = this->node->next();
+            return *this;
+        }
+
+        list_iterator operator++(int) {
+            list_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        list_iterator& operator--() {
+            this->node = (this->node == nullptr ? this->owner->back() : this->node->prev());
+            return *this;
+        }
+
+        list_iterator operator--(int) {
+            list_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        friend bool operator==(const list_iterator& a, const list_iterator& b) { return a.node == b.node; }
+        friend bool operator!=(const list_iterator& a, const list_iterator& b) { return a.node != b.node; }
+
+        linked_node<T>* node_ptr() const { return this->node; }
+};
+
+// Doubly linked list. Nodes created by the list come from its own
+// node_pool: popped and removed nodes are recycled by later pushes, and
+// clear() and the destructor hand every slab back at once. Every node
+// the list links comes from that pool: a node passed in by pointer only
+// has its value copied into a new one, and stays the caller's.
 template <typename T> class list {
     private:
         int64_t s;
         linked_node<T> *head, *tail;
+        node_pool<linked_node<T>> pool;
+
+        void relink(linked_node<T>* first);
+        void link_before(linked_node<T>* pos, linked_node<T>* first, linked_node<T>* last);
+        void unlink_range(linked_node<T>* first, linked_node<T>* last);
+
+        void link_front(linked_node<T>* node);
+        void link_back(linked_node<T>* node);
+        void link_at(int64_t idx, linked_node<T>* node);
     public:
-        list() : s(0), head(nullptr), tail(nullptr) {}
-        list(linked_node<T> node) : s(1), head(&node), tail(&node) {}
-        list(T value) : s(1) {
-            linked_node<T> node(value);
-            this->head = this->tail = &node;
-        }
+        typedef list_iterator<T, T> iterator;
+        typedef list_iterator<T, const T> const_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        list() : s(0), head(nullptr), tail(nullptr), pool(16) {}
+        list(linked_node<T> node) : list() { this->push_back(node.value()); }
+        list(T value) : list() { this->push_back(value); }
+        list(const list<T>& copy);
+        list(list<T>&& other);
 
-        ~list() {}
+        ~list() { this->clear(); }
+
+        list<T>& operator=(list<T> copy);
+        void swap(list<T>& other);
 
         void push_front(linked_node<T>* node);
         void push_front(T value);
@@ -29,6 +109,10 @@ template <typename T> class list {
         void insert(int64_t idx, linked_node<T>* node);
         void insert(int64_t idx, T value);
 
+        void splice(const_iterator pos, list<T>& other, const_iterator first, const_iterator last);
+        void splice(const_iterator pos, list<T>&& other);
+        void append(list<T>&& other);
+
         T pop_front();
         T pop_back();
         void remove(int64_t idx);
@@ -42,22 +126,60 @@ template <typename T> class list {
 
         void reverse();
         void sort();
-        list<T> merge(list<T> ll) const;
+        void parallel_sort(int64_t threads = 0);
+        list<T> merge(const list<T>& ll) const;
 
         linked_node<T>* front() const;
         linked_node<T>* back() const;
         linked_node<T> get(int64_t idx) const;
         linked_node<T>* get_ptr(int64_t idx) const;
 
-        T operator[](int64_t idx);
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        reverse_iterator rbegin();
+        reverse_iterator rend();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator rend() const;
+
+        T operator[](int64_t idx) const;
         //linked_node<T>* operator[](int64_t idx);
 
         template <typename U>
         friend std::ostream& operator<<(std::ostream& out, const list<U>& l);
 };
 
-template <typename T> void list<T>::push_front(linked_node<T>* node) {
+template <typename T> list<T>::list(const list<T>& copy) : list() {
+    for (linked_node<T>* node = copy.head; node != nullptr; node = node->next()) {
+        this->push_back(node->value());
+    }
+}
+
+template <typename T> list<T>::list(list<T>&& other) : list() {
+    this->swap(other);
+}
+
+template <typename T> list<T>& list<T>::operator=(list<T> copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T> void list<T>::swap(list<T>& other) {
+    std::swap(this->s, other.s);
+    std::swap(this->head, other.head);
+    std::swap(this->tail, other.tail);
+    this->pool.swap(other.pool);
+}
+
+template <typename T> void list<T>::link_front(linked_node<T>* node) {
+    node->prev(nullptr, false);
+
     if (this->is_empty()) {
+        node->next(nullptr);
         this->head = this->tail = node;
     } else {
         node->next(this->head);
@@ -66,13 +188,19 @@ template <typename T> void list<T>::push_front(linked_node<T>* node) {
     ++this->s;
 }
 
+template <typename T> void list<T>::push_front(linked_node<T>* node) {
+    this->push_front(node->value());
+}
+
 template <typename T> void list<T>::push_front(T value) {
-    linked_node<T>* node = new linked_node<T>(node);
-    this->push_front(node);
+    this->link_front(this->pool.acquire(value));
 }
 
-template <typename T> void list<T>::push_back(linked_node<T>* node) {
+template <typename T> void list<T>::link_back(linked_node<T>* node) {
+    node->next(nullptr);
+
     if (this->is_empty()) {
+        node->prev(nullptr, false);
         this->head = this->tail = node;
     } else {
         node->prev(this->tail);
@@ -81,27 +209,126 @@ template <typename T> void list<T>::push_back(linked_node<T>* node) {
     ++this->s;
 }
 
+template <typename T> void list<T>::push_back(linked_node<T>* node) {
+    this->push_back(node->value());
+}
+
 template <typename T> void list<T>::push_back(T value) {
-    linked_node<T>* node = new linked_node<T>(value);
-    this->push_back(node);
+    this->link_back(this->pool.acquire(value));
 }
 
-template <typename T> void list<T>::insert(int64_t idx, linked_node<T>* node) {
-    assert(idx >= 0 && idx < this->s);
+// Places the node so that it ends up at position idx; idx == size()
+// appends it.
+template <typename T> void list<T>::link_at(int64_t idx, linked_node<T>* node) {
+    assert(idx >= 0 && idx <= this->s);
 
-    if (idx == 0) this->push_front(node);
-    else if (idx == this->s-1) this->push_back(node);
+    if (idx == 0) this->link_front(node);
+    else if (idx == this->s) this->link_back(node);
     else {
         linked_node<T>* loc = this->get_ptr(idx);
         loc->prev()->next(node);
         loc->prev(node);
+        ++this->s;
     }
-    ++this->s;
+}
+
+template <typename T> void list<T>::insert(int64_t idx, linked_node<T>* node) {
+    this->insert(idx, node->value());
 }
 
 template <typename T> void list<T>::insert(int64_t idx, T value) { 
-    linked_node<T> node(value);
-    this->insert(idx, node);
+    this->link_at(idx, this->pool.acquire(value));
+}
+
+// Links the chain first..last in before pos, or at the back when pos is
+// nullptr. Sizes are left to the caller.
+template <typename T>
+void list<T>::link_before(linked_node<T>* pos, linked_node<T>* first, linked_node<T>* last) {
+    linked_node<T>* before = (pos == nullptr ? this->tail : pos->prev());
+
+    first->prev(before, false);
+    last->next(pos, false);
+
+    if (before != nullptr) before->next(first, false);
+    else this->head = first;
+
+    if (pos != nullptr) pos->prev(last, false);
+    else this->tail = last;
+}
+
+// Cuts the chain first..last out of the list without releasing it.
+template <typename T> void list<T>::unlink_range(linked_node<T>* first, linked_node<T>* last) {
+    linked_node<T> *before = first->prev(),
+                   *after = last->next();
+
+    if (before != nullptr) before->next(after, false);
+    else this->head = after;
+
+    if (after != nullptr) after->prev(before, false);
+    else this->tail = before;
+}
+
+// Moves [first, last) of other in front of pos. Within one list the nodes
+// are relinked in O(1), and pos must not lie inside the range. Nodes
+// belong to their list's pool, so a range taken from another list is
+// moved value by value unless it is the whole list.
+template <typename T>
+void list<T>::splice(const_iterator pos, list<T>& other, const_iterator first, const_iterator last) {
+    if (first == last)
+        return;
+
+    if (&other != this) {
+        if (first == other.cbegin() && last == other.cend()) {
+            this->splice(pos, std::move(other));
+            return;
+        }
+
+        linked_node<T>* node = first.node_ptr();
+
+        while (node != last.node_ptr()) {
+            linked_node<T>* next = node->next();
+
+            other.unlink_range(node, node);
+            --other.s;
+
+            linked_node<T>* moved = this->pool.acquire(std::move(node->value_ref()));
+            this->link_before(pos.node_ptr(), moved, moved);
+            ++this->s;
+
+            other.pool.release(node);
+
+            node = next;
+        }
+
+        return;
+    }
+
+    linked_node<T> *f = first.node_ptr(),
+                   *l = (last.node_ptr() == nullptr ? this->tail : last.node_ptr()->prev());
+
+    if (pos.node_ptr() == last.node_ptr() || pos.node_ptr() == f)
+        return;
+
+    this->unlink_range(f, l);
+    this->link_before(pos.node_ptr(), f, l);
+}
+
+// Moves every node of other in front of pos in O(1), taking over its
+// pool; other is left empty.
+template <typename T> void list<T>::splice(const_iterator pos, list<T>&& other) {
+    if (&other == this || other.is_empty())
+        return;
+
+    this->pool.absorb(other.pool);
+    this->link_before(pos.node_ptr(), other.head, other.tail);
+    this->s += other.s;
+
+    other.head = other.tail = nullptr;
+    other.s = 0;
+}
+
+template <typename T> void list<T>::append(list<T>&& other) {
+    this->splice(this->cend(), std::move(other));
 }
 
 template <typename T> T list<T>::pop_front() {
@@ -110,9 +337,14 @@ template <typename T> T list<T>::pop_front() {
         this->head = this->head->next();
         if (--this->s == 0) {
             this->tail = nullptr;
+        } else {
+            this->head->prev(nullptr, false);
         }
 
-        return removed_front->value();
+        T value = removed_front->value();
+        this->pool.release(removed_front);
+
+        return value;
     }
 
     throw std::out_of_range("The indexed list is empty");
@@ -123,13 +355,17 @@ template <typename T> T list<T>::pop_back() {
         linked_node<T>* removed_back = this->tail;
 
         this->tail = this->tail->prev();
-        this->tail->next(nullptr);
 
         if (--this->s == 0) {
             this->head = nullptr;
+        } else {
+            this->tail->next(nullptr);
         }
 
-        return removed_back->value();
+        T value = removed_back->value();
+        this->pool.release(removed_back);
+
+        return value;
     }
 
     return static_cast<T>(0);
@@ -144,6 +380,7 @@ template <typename T> void list<T>::remove(int64_t idx) {
         linked_node<T>* removed = this->get_ptr(idx);
         
         removed->prev()->next(removed->next());
+        this->pool.release(removed);
 
         --this->s;
     }
@@ -155,7 +392,20 @@ template <typename T> void list<T>::remove(T value) {
     else this->remove(idx);
 }
 
+// Only values that need destroying are visited; the slabs themselves
+// are released in one sweep.
 template <typename T> void list<T>::clear() {
+    if (!std::is_trivially_destructible<T>::value) {
+        linked_node<T>* node = this->head;
+
+        while (node != nullptr) {
+            linked_node<T>* next = node->next();
+            this->pool.release(node);
+            node = next;
+        }
+    }
+
+    this->pool.release_all();
     this->head = this->tail = nullptr;
     this->s = 0;
 }
@@ -163,6 +413,14 @@ template <typename T> void list<T>::clear() {
 template <typename T> void list<T>::resize(int64_t new_size) {
     if (new_size < this->s && new_size > 0) {
         linked_node<T>* new_tail = this->get_ptr(new_size-1);
+
+        for (linked_node<T>* node = new_tail->next(); node != nullptr; ) {
+            linked_node<T>* next = node->next();
+            this->pool.release(node);
+            node = next;
+        }
+
+        new_tail->next(nullptr);
         this->tail = new_tail;
         this->s = new_size;
     } else if (new_size == 0) {
@@ -201,7 +459,43 @@ template <typename T> linked_node<T>* list<T>::get_ptr(int64_t idx) const {
     return ptr;
 }
 
-template <typename T> T list<T>::operator[](int64_t idx) {
+template <typename T> typename list<T>::iterator list<T>::begin() {
+    return iterator(this->head, this);
+}
+
+template <typename T> typename list<T>::iterator list<T>::end() {
+    return iterator(nullptr, this);
+}
+
+template <typename T> typename list<T>::const_iterator list<T>::begin() const {
+    return const_iterator(this->head, this);
+}
+
+template <typename T> typename list<T>::const_iterator list<T>::end() const {
+    return const_iterator(nullptr, this);
+}
+
+template <typename T> typename list<T>::const_iterator list<T>::cbegin() const { return this->begin(); }
+
+template <typename T> typename list<T>::const_iterator list<T>::cend() const { return this->end(); }
+
+template <typename T> typename list<T>::reverse_iterator list<T>::rbegin() {
+    return reverse_iterator(this->end());
+}
+
+template <typename T> typename list<T>::reverse_iterator list<T>::rend() {
+    return reverse_iterator(this->begin());
+}
+
+template <typename T> typename list<T>::const_reverse_iterator list<T>::rbegin() const {
+    return const_reverse_iterator(this->end());
+}
+
+template <typename T> typename list<T>::const_reverse_iterator list<T>::rend() const {
+    return const_reverse_iterator(this->begin());
+}
+
+template <typename T> T list<T>::operator[](int64_t idx) const {
     return this->get_ptr(idx)->value();
 }
 
@@ -212,61 +506,159 @@ template <typename T> void list<T>::reverse() {
     linked_node<T> *front = this->head, *back = this->tail;
 
     for (uint64_t k = 0; k <= (this->s/2 - (this->s+1)%2) && front != nullptr && back != nullptr; k++) {
-        swap(front, back);
+        ::swap(front, back);
         front = front->next();
         back = back->prev();
     }
 }
 
-template <typename T> inline void quicksort(list<T>& l, int64_t lo, int64_t hi) {
-    if (lo >= hi || lo < 0) {
-        return;
+// Merges two sorted, nullptr-terminated chains through their next links.
+// On equal values the node from the first chain goes first, so merging
+// an earlier run with a later one is stable.
+template <typename T> linked_node<T>* merge_runs(linked_node<T>* a, linked_node<T>* b) {
+    linked_node<T> *head = nullptr, *last = nullptr;
+
+    while (a != nullptr && b != nullptr) {
+        linked_node<T>* next;
+
+        if (b->value_ref() < a->value_ref()) {
+            next = b;
+            b = b->next();
+        } else {
+            next = a;
+            a = a->next();
+        }
+
+        if (last == nullptr) head = next;
+        else last->next(next, false);
+
+        last = next;
     }
 
-    int64_t p = partition(l, lo, hi);
+    linked_node<T>* rest = (a != nullptr ? a : b);
 
-    quicksort(l, lo, p-1);
-    quicksort(l, p+1, hi);
-}
+    if (last == nullptr) return rest;
 
-template <typename T> int64_t partition(list<T>& l, int64_t lo, int64_t hi) {
-    // high_node->value() is the pivot
-    linked_node<T> *curr_node = l[lo], *high_node = l[hi];
+    last->next(rest, false);
 
-    int64_t k = lo-1;
+    return head;
+}
 
-    linked_node<T>* swap_node = (k < 0 || k >= l.size() ? nullptr : l[k]);
+// Bottom-up merge sort of a nullptr-terminated chain. runs[i] holds a
+// sorted run of 2^i nodes; each new node is carried up through the
+// occupied slots like a binary counter, merging equal sized runs. Only
+// next links are maintained.
+template <typename T> linked_node<T>* merge_sort_chain(linked_node<T>* node) {
+    linked_node<T>* runs[64] = { nullptr };
 
-    for (int64_t j = lo; j < hi; j++) {
-        if (curr_node->value() <= high_node->value()) {
-            ++k;
+    while (node != nullptr) {
+        linked_node<T>* carry = node;
+        node = node->next();
+        carry->next(nullptr, false);
 
-            swap_node = (swap_node == nullptr ? l[k] : swap_node->next());
+        int64_t k = 0;
 
-            swap(curr_node, swap_node);
+        for (; runs[k] != nullptr; k++) {
+            carry = merge_runs(runs[k], carry);
+            runs[k] = nullptr;
         }
 
-        curr_node = curr_node->next();
+        runs[k] = carry;
     }
 
-    ++k;
+    // Higher slots hold earlier elements.
+    linked_node<T>* sorted = nullptr;
 
-    swap_node = (swap_node == nullptr ? l[k] : swap_node->next());
+    for (int64_t k = 0; k < 64; k++) {
+        if (runs[k] != nullptr) sorted = merge_runs(runs[k], sorted);
+    }
 
-    swap(swap_node, high_node);
+    return sorted;
+}
 
-    return k;
+// Rebuilds the prev links and the tail after the chain has been relinked.
+template <typename T> void list<T>::relink(linked_node<T>* first) {
+    this->head = first;
+    this->tail = nullptr;
+
+    for (linked_node<T>* node = first; node != nullptr; node = node->next()) {
+        node->prev(this->tail, false);
+        this->tail = node;
+    }
 }
 
-// Quicksort
+// Stable merge sort. Nodes are relinked rather than having their values
+// swapped, and no memory is allocated.
 template <typename T> void list<T>::sort() {
-    quicksort(*this, 0, this->s-1);
+    if (this->s < 2)
+        return;
+
+    this->tail->next(nullptr, false);
+    this->relink(merge_sort_chain(this->head));
+}
+
+// Cuts the list into one run per thread, sorts the runs concurrently and
+// then merges neighbouring runs in parallel rounds. Lists too short to
+// benefit are sorted serially. threads == 0 uses every hardware thread.
+template <typename T> void list<T>::parallel_sort(int64_t threads) {
+    const int64_t cutoff = 1 << 14;
+
+    if (threads <= 0)
+        threads = static_cast<int64_t>(std::thread::hardware_concurrency());
+
+    if (threads > this->s / cutoff)
+        threads = this->s / cutoff;
+
+    if (threads < 2) {
+        this->sort();
+        return;
+    }
+
+    linked_node<T>** runs = new linked_node<T>*[threads];
+    linked_node<T>* node = this->head;
+
+    for (int64_t t = 0; t < threads; t++) {
+        int64_t length = this->s / threads + (t < this->s % threads ? 1 : 0);
+
+        runs[t] = node;
+
+        for (int64_t k = 1; k < length; k++) node = node->next();
+
+        linked_node<T>* next = node->next();
+        node->next(nullptr, false);
+        node = next;
+    }
+
+    std::thread* workers = new std::thread[threads];
+
+    for (int64_t t = 0; t < threads; t++) {
+        workers[t] = std::thread([runs, t]() { runs[t] = merge_sort_chain(runs[t]); });
+    }
+
+    for (int64_t t = 0; t < threads; t++) workers[t].join();
+
+    for (int64_t width = 1; width < threads; width *= 2) {
+        int64_t merges = 0;
+
+        for (int64_t t = 0; t + width < threads; t += 2*width) {
+            workers[merges++] = std::thread([runs, t, width]() {
+                runs[t] = merge_runs(runs[t], runs[t + width]);
+            });
+        }
+
+        for (int64_t k = 0; k < merges; k++) workers[k].join();
+    }
+
+    this->relink(runs[0]);
+
+    delete[] workers;
+    delete[] runs;
 }
 
-template <typename T> list<T> list<T>::merge(list<T> ll) const {
+template <typename T> list<T> list<T>::merge(const list<T>& ll) const {
     list<T> merged;
 
-    linked_node<T>* first = this->head, second = ll.front();
+    linked_node<T> *first = this->head, *second = ll.front();
 
     for (int64_t k = 0; k < this->s; k++) {
         merged.push_back(first->value());
@@ -292,7 +684,7 @@ template <typename T> linked_node<T>* list<T>::back() const {
 template <typename T> linked_node<T> list<T>::get(int64_t idx) const {
     assert(idx >= 0 && idx < this->s);
 
-    return *(this->get_ptr());
+    return *(this->get_ptr(idx));
 }
 
 template <typename T> std::ostream& operator<<(std::ostream& out, const list<T>& l) {
@@ -311,7 +703,7 @@ template <typename T> std::ostream& operator<<(std::ostream& out, const list<T>*
     return out;
 }
 
-template <typename T> int64_t binary_search(list<T> l, T value) {
+template <typename T> int64_t binary_search(const list<T>& l, T value) {
     int64_t L = 0, R = l.size()-1;
 
     while (L <= R) {
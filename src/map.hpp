@@ -5,61 +5,95 @@
 #include "pair.hpp"
 #include "rb_tree.hpp"
 
-template <typename K, typename V> class map : public rb_tree<pair<K,V>> {
+// Ordered map over a tree backend of pairs, which order by key alone:
+// rb_tree by default, or b_tree. search returns the backend's handle to
+// the entry, an rb_node for rb_tree and a pointer to the pair for b_tree.
+template <typename K, typename V, typename Tree = rb_tree<pair<K,V>>> class map : public Tree {
+    private:
+        static void overwrite(rb_node<pair<K,V>>* node, const pair<K,V>& p) { node->value(p); }
+        static void overwrite(pair<K,V>* entry, const pair<K,V>& p) { *entry = p; }
     public:
         void insert(K k, V v);
         void remove(K k);
         void remove(K k, V v);
 
-        rb_node<pair<K,V>>* search(K k) const;
+        auto search(K k) const;
+
+        auto lower_bound(K k) const;
+        auto upper_bound(K k) const;
+        auto equal_range(K k) const;
+
+        auto floor(K k) const;
+        auto ceiling(K k) const;
+
+        template <typename F> void for_each_in_range(K lo, K hi, F fn) const;
 };
 
-template <typename K, typename V> 
-void map<K,V>::insert(K k, V v) {
-    pair<K,V> p(k,v);
-    rb_node<pair<K,V>> *s = map<K,V>::search(k);
+template <typename K, typename V, typename Tree>
+auto map<K,V,Tree>::search(K k) const {
+    return this->find(pair<K,V>(k, V()));
+}
 
-    if (s == nullptr) {
-        rb_node<pair<K,V>> *node = new rb_node<pair<K,V>>(p);
-        rb_tree<pair<K,V>>::insert(node);
-    } else {
-        s->value(p);
-    }
+template <typename K, typename V, typename Tree>
+auto map<K,V,Tree>::lower_bound(K k) const {
+    return Tree::lower_bound(pair<K,V>(k, V()));
 }
 
-template <typename K, typename V> 
-void map<K,V>::remove(K k) {
-    rb_node<pair<K,V>> *node = this->search(k);
+template <typename K, typename V, typename Tree>
+auto map<K,V,Tree>::upper_bound(K k) const {
+    return Tree::upper_bound(pair<K,V>(k, V()));
+}
 
-    if (node == nullptr) 
-        return;
+template <typename K, typename V, typename Tree>
+auto map<K,V,Tree>::equal_range(K k) const {
+    return Tree::equal_range(pair<K,V>(k, V()));
+}
 
-    rb_tree<pair<K,V>>::remove(node);
+// The entry with the greatest key not greater than k.
+template <typename K, typename V, typename Tree>
+auto map<K,V,Tree>::floor(K k) const {
+    return Tree::floor(pair<K,V>(k, V()));
 }
 
+// The entry with the least key not less than k.
+template <typename K, typename V, typename Tree>
+auto map<K,V,Tree>::ceiling(K k) const {
+    return Tree::ceiling(pair<K,V>(k, V()));
+}
 
-template <typename K, typename V> 
-void map<K,V>::remove(K k, V v) {
-    rb_node<pair<K,V>> *node = rb_tree<pair<K,V>>::search(k);
+// Calls fn on every entry whose key is in [lo, hi), in key order.
+template <typename K, typename V, typename Tree> template <typename F>
+void map<K,V,Tree>::for_each_in_range(K lo, K hi, F fn) const {
+    Tree::for_each_in_range(pair<K,V>(lo, V()), pair<K,V>(hi, V()), fn);
+}
 
-    if (node == nullptr)
-        return;
+// An existing key is overwritten in place, without taking a new node.
+template <typename K, typename V, typename Tree>
+void map<K,V,Tree>::insert(K k, V v) {
+    pair<K,V> p(k,v);
+    auto s = this->search(k);
 
-    rb_tree<pair<K,V>>::remove(node);
+    if (s == nullptr) {
+        Tree::insert(p);
+    } else {
+        overwrite(s, p);
+    }
 }
 
+template <typename K, typename V, typename Tree>
+void map<K,V,Tree>::remove(K k) {
+    auto node = this->search(k);
 
-template <typename K, typename V> 
-rb_node<pair<K,V>>* map<K,V>::search(K k) const {
-    rb_node<pair<K,V>> *current = rb_tree<pair<K,V>>::root();
-
-    while (current != nullptr && current->value().key() != k) {
-        bool direction = (current->value().key() <= k);
+    if (node == nullptr)
+        return;
 
-        current = (direction ? current->right() : current->left());
-    }
+    Tree::remove(node);
+}
 
-    return current;
+// Removes k only while it maps to v.
+template <typename K, typename V, typename Tree>
+void map<K,V,Tree>::remove(K k, V v) {
+    Tree::remove(pair<K,V>(k,v));
 }
 
 #endif
@@ -0,0 +1,163 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+
+// Bounded lock-free queue for any number of producers and consumers
+// (Vyukov's sequenced ring). Every cell carries a sequence number saying
+// whose turn it is: a producer may fill cell pos & mask when its sequence
+// equals pos, and a consumer may empty it when the sequence equals pos+1.
+// Producers and consumers each claim positions with one CAS on their own
+// counter, so they only meet on the cells themselves.
+//
+// The capacity is rounded up to a power of two. try_push and try_pop
+// fail rather than wait when the queue is full or empty; push and pop
+// retry, yielding between attempts.
+template <typename T> class mpmc_queue {
+    private:
+        struct cell {
+            std::atomic<uint64_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* item() { return reinterpret_cast<T*>(this->storage); }
+        };
+
+        cell* buffer;
+        uint64_t mask;
+
+        // Kept on separate cache lines so that producers and consumers do
+        // not invalidate each other's counter.
+        alignas(64) std::atomic<uint64_t> enqueue_pos;
+        alignas(64) std::atomic<uint64_t> dequeue_pos;
+    public:
+        mpmc_queue(int64_t capacity = 1024);
+        mpmc_queue(const mpmc_queue& copy) = delete;
+
+        ~mpmc_queue();
+
+        mpmc_queue& operator=(const mpmc_queue& copy) = delete;
+
+        bool try_push(T value);
+        bool try_pop(T& value);
+
+        void push(T value);
+        T pop();
+
+        int64_t capacity() const;
+        int64_t size() const;
+        bool is_empty() const;
+};
+
+template <typename T> mpmc_queue<T>::mpmc_queue(int64_t capacity) : enqueue_pos(0), dequeue_pos(0) {
+    assert(capacity >= 1);
+
+    uint64_t cells = 2;
+
+    while (cells < static_cast<uint64_t>(capacity)) cells *= 2;
+
+    this->buffer = new cell[cells];
+    this->mask = cells - 1;
+
+    for (uint64_t k = 0; k < cells; k++) {
+        this->buffer[k].sequence.store(k, std::memory_order_relaxed);
+    }
+}
+
+template <typename T> mpmc_queue<T>::~mpmc_queue() {
+    T value;
+
+    while (this->try_pop(value)) {}
+
+    delete[] this->buffer;
+}
+
+template <typename T> bool mpmc_queue<T>::try_push(T value) {
+    uint64_t pos = this->enqueue_pos.load(std::memory_order_relaxed);
+    cell* c;
+
+    while (true) {
+        c = &this->buffer[pos & this->mask];
+
+        uint64_t seq = c->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq - pos);
+
+        if (diff == 0) {
+            if (this->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // The cell still holds the value from one lap ago: full.
+            return false;
+        } else {
+            pos = this->enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    new (c->item()) T(std::move(value));
+    c->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T> bool mpmc_queue<T>::try_pop(T& value) {
+    uint64_t pos = this->dequeue_pos.load(std::memory_order_relaxed);
+    cell* c;
+
+    while (true) {
+        c = &this->buffer[pos & this->mask];
+
+        uint64_t seq = c->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq - (pos + 1));
+
+        if (diff == 0) {
+            if (this->dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // Not filled yet: empty.
+            return false;
+        } else {
+            pos = this->dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    T* item = c->item();
+
+    value = std::move(*item);
+    item->~T();
+
+    // Hand the cell to the producer one lap ahead.
+    c->sequence.store(pos + this->mask + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T> void mpmc_queue<T>::push(T value) {
+    while (!this->try_push(value)) std::this_thread::yield();
+}
+
+template <typename T> T mpmc_queue<T>::pop() {
+    T value;
+
+    while (!this->try_pop(value)) std::this_thread::yield();
+
+    return value;
+}
+
+template <typename T> int64_t mpmc_queue<T>::capacity() const { return static_cast<int64_t>(this->mask + 1); }
+
+// Approximate while other threads are pushing or popping.
+template <typename T> int64_t mpmc_queue<T>::size() const {
+    uint64_t tail = this->enqueue_pos.load(std::memory_order_relaxed),
+             head = this->dequeue_pos.load(std::memory_order_relaxed);
+
+    return (tail > head ? static_cast<int64_t>(tail - head) : 0);
+}
+
+template <typename T> bool mpmc_queue<T>::is_empty() const { return (this->size() == 0); }
+
+#endif
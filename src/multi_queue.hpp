@@ -0,0 +1,184 @@
+#ifndef MULTI_QUEUE_H
+#define MULTI_QUEUE_H
+
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <thread>
+#include "d_ary_heap.hpp"
+#include "MACROS.hpp"
+
+// Relaxed concurrent priority queue (MultiQueue). Elements are spread over
+// c*P independently locked d-ary heaps, where P is the number of threads
+// expected to use it. insert() adds to one random heap; pop() looks at the
+// roots of two random heaps and takes the better one, so threads rarely
+// contend for the same lock.
+//
+// pop() does not always return the best element overall: the rank of the
+// returned element is O(c*P) in expectation. c is the relaxation knob,
+// trading ordering quality (small c) against contention (large c); with
+// a single heap the queue is exact.
+template <typename T, typename Compare = std::greater<T>> class multi_queue {
+    private:
+        struct alignas(64) locked_heap {
+            std::mutex lock;
+            d_ary_heap<T, 4, Compare> heap;
+        };
+
+        int64_t queue_count;
+        locked_heap* heaps;
+        std::atomic<int64_t> queue_size;
+        Compare compare;
+
+        int64_t random_queue() const;
+    public:
+        multi_queue(int64_t threads = std::thread::hardware_concurrency(), int64_t c = 2,
+                    Compare compare = Compare());
+        multi_queue(const multi_queue& copy) = delete;
+
+        ~multi_queue();
+
+        multi_queue& operator=(const multi_queue& copy) = delete;
+
+        void insert(T value);
+
+        bool try_pop(T& value);
+        T pop();
+
+        int64_t queues() const;
+        int64_t size() const;
+        bool is_empty() const;
+};
+
+template <typename T, typename Compare>
+int64_t multi_queue<T,Compare>::random_queue() const {
+    thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^
+                                  std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return static_cast<int64_t>(state % static_cast<uint64_t>(this->queue_count));
+}
+
+template <typename T, typename Compare>
+multi_queue<T,Compare>::multi_queue(int64_t threads, int64_t c, Compare compare) : queue_size(0),
+                                                                                  compare(compare) {
+    assert(c >= 1);
+
+    this->queue_count = MAX(threads, static_cast<int64_t>(1)) * c;
+    this->heaps = new locked_heap[this->queue_count];
+
+    // Every heap orders by the same comparator that picks between roots.
+    for (int64_t k = 0; k < this->queue_count; k++) {
+        this->heaps[k].heap = d_ary_heap<T, 4, Compare>(compare);
+    }
+}
+
+template <typename T, typename Compare>
+multi_queue<T,Compare>::~multi_queue() {
+    delete[] this->heaps;
+}
+
+// Tries random heaps until one is not held by another thread.
+template <typename T, typename Compare>
+void multi_queue<T,Compare>::insert(T value) {
+    while (true) {
+        locked_heap& q = this->heaps[this->random_queue()];
+
+        if (!q.lock.try_lock()) continue;
+
+        // Counted before the element becomes visible, so that the size
+        // never drops below zero when a pop races with this insert.
+        ++this->queue_size;
+
+        q.heap.insert(value);
+        q.lock.unlock();
+
+        return;
+    }
+}
+
+// Pops from the better root of two random heaps. Returns false only when
+// every heap was seen empty.
+template <typename T, typename Compare>
+bool multi_queue<T,Compare>::try_pop(T& value) {
+    for (int64_t attempt = 0; attempt < 2*this->queue_count; attempt++) {
+        if (this->queue_size.load(std::memory_order_relaxed) == 0)
+            return false;
+
+        int64_t i = this->random_queue(),
+                j = this->random_queue();
+
+        if (i == j) j = (j + 1) % this->queue_count;
+
+        locked_heap &a = this->heaps[i],
+                    &b = this->heaps[j];
+
+        // i == j only when there is a single heap.
+        bool same = (i == j);
+
+        if (!a.lock.try_lock()) continue;
+
+        if (!same && !b.lock.try_lock()) {
+            a.lock.unlock();
+            continue;
+        }
+
+        locked_heap* best = (a.heap.is_empty() ? &b :
+                             b.heap.is_empty() ? &a :
+                             this->compare(b.heap.root(), a.heap.root()) ? &b : &a);
+
+        bool found = !best->heap.is_empty();
+
+        if (found) value = best->heap.pop();
+
+        if (!same) b.lock.unlock();
+        a.lock.unlock();
+
+        if (found) {
+            --this->queue_size;
+            return true;
+        }
+    }
+
+    // Random probes kept missing; sweep every heap once before giving up.
+    for (int64_t k = 0; k < this->queue_count; k++) {
+        std::lock_guard<std::mutex> guard(this->heaps[k].lock);
+
+        if (!this->heaps[k].heap.is_empty()) {
+            value = this->heaps[k].heap.pop();
+            --this->queue_size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename T, typename Compare>
+T multi_queue<T,Compare>::pop() {
+    T value;
+
+    if (!this->try_pop(value))
+        throw std::out_of_range("The queue is empty");
+
+    return value;
+}
+
+template <typename T, typename Compare>
+int64_t multi_queue<T,Compare>::queues() const { return this->queue_count; }
+
+// Approximate while other threads are inserting or popping.
+template <typename T, typename Compare>
+int64_t multi_queue<T,Compare>::size() const { return this->queue_size.load(); }
+
+template <typename T, typename Compare>
+bool multi_queue<T,Compare>::is_empty() const { return (this->size() == 0); }
+
+#endif
@@ -4,26 +4,65 @@
 #pragma once
 #include <iostream>
 
-template <typename T> class linked_node {
+// Pair of links for a doubly linked list of D objects, where D derives
+// from list_hook<D>. linked_node uses it to chain its nodes, and a type
+// that derives from it directly can be linked into an intrusive_list in
+// place. Copying an object does not copy its links, so a copy starts out
+// unlinked.
+template <typename D> class list_hook {
+    private:
+        D *next_node, *prev_node;
+    public:
+        list_hook(D* n = nullptr, D* p = nullptr) : next_node(n), prev_node(p) {}
+        list_hook(const list_hook&) : next_node(nullptr), prev_node(nullptr) {}
+
+        list_hook& operator=(const list_hook&) { return *this; }
+
+        void next(D* n, bool set_prev = true);
+        D* next() const;
+
+        void prev(D* p, bool set_next = true);
+        D* prev() const;
+};
+
+template <typename D> void list_hook<D>::next(D* n, bool set_prev) {
+    this->next_node = n; 
+    if (this->next_node != nullptr && set_prev) { 
+        this->next_node->prev(static_cast<D*>(this), false); 
+    }
+}
+
+template <typename D> D* list_hook<D>::next() const { 
+    return this->next_node; 
+}
+
+template <typename D> void list_hook<D>::prev(D* p, bool set_next) {
+    this->prev_node = p;
+    if (this->prev_node != nullptr && set_next) { 
+        this->prev_node->next(static_cast<D*>(this));
+    }
+}
+
+template <typename D> D* list_hook<D>::prev() const {
+    return this->prev_node;
+}
+
+template <typename T> class linked_node : public list_hook<linked_node<T>> {
     private:
         T v;
-        linked_node<T> *next_node, *prev_node;
     public:
-        linked_node() : v(0), next_node(nullptr), prev_node(nullptr) {}
-        linked_node(T v) : v(v), next_node(nullptr), prev_node(nullptr) {}
-        linked_node(T v, linked_node* n) : v(v), next_node(n), prev_node(nullptr) {}
-        linked_node(T v, linked_node* n, linked_node* p) : v(v), next_node(n), prev_node(p){}
+        linked_node() : v(0) {}
+        linked_node(T v) : v(v) {}
+        linked_node(T v, linked_node* n) : list_hook<linked_node<T>>(n), v(v) {}
+        linked_node(T v, linked_node* n, linked_node* p) : list_hook<linked_node<T>>(n, p), v(v) {}
 
         ~linked_node() {}
 
         void value(T v);
         T value() const;
 
-        void next(linked_node* n, bool set_prev = true);
-        linked_node<T>* next() const;
-
-        void prev(linked_node* p, bool set_next = true);
-        linked_node<T>* prev() const;
+        T& value_ref();
+        const T& value_ref() const;
 
         bool operator==(linked_node<T> node) const;
         bool operator==(linked_node<T>* node) const;
@@ -44,26 +83,12 @@ template <typename T> T linked_node<T>::value() const {
     return this->v; 
 }
 
-template <typename T> void linked_node<T>::next(linked_node* n, bool set_prev) {
-    this->next_node = n; 
-    if (this->next_node != nullptr && set_prev) { 
-        this->next_node->prev(this, false); 
-    }
-}
-
-template <typename T> linked_node<T>* linked_node<T>::next() const { 
-    return this->next_node; 
+template <typename T> T& linked_node<T>::value_ref() {
+    return this->v;
 }
 
-template <typename T> void linked_node<T>::prev(linked_node* p, bool set_next) {
-    this->prev_node = p;
-    if (this->prev_node != nullptr && set_next) { 
-        this->prev_node->next(this);
-    }
-}
-
-template <typename T> linked_node<T>* linked_node<T>::prev() const {
-    return this->prev_node;
+template <typename T> const T& linked_node<T>::value_ref() const {
+    return this->v;
 }
 
 template <typename T> bool linked_node<T>::operator==(linked_node<T> node) const {
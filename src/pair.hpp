@@ -1,6 +1,9 @@
 #ifndef PAIR_H
 #define PAIR_H
 
+#pragma once
+#include <iostream>
+
 template <typename K, typename V> class pair {
     private:
         K k;
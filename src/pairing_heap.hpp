@@ -0,0 +1,359 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#pragma once
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include "pool.hpp"
+#include "vector.hpp"
+#include "MACROS.hpp"
+
+// Meldable heap: a heap-ordered multiway tree in which each node keeps a
+// pointer to its first child and to its next sibling. insert and meld
+// link two roots in O(1); pop removes the root and pairs up its children
+// left to right, then folds the pairs right to left, in amortized O(log n).
+//
+// Nodes come from a node_pool, and melding absorbs the other heap's pool,
+// so no node is ever copied or reallocated. Ordering follows d_ary_heap:
+// compare(a, b) is true when a belongs above b.
+//
+// The rest of max_heap's interface is here too. search and operator<<
+// walk the tree in preorder, root first, since there is no array; an
+// index from search counts positions in that order and, as in max_heap,
+// only says where the value was until the heap next changes. reserve
+// readies pool slots for that many elements.
+template <typename T, typename Compare = std::greater<T>> class pairing_heap {
+    private:
+        struct pairing_node {
+            T v;
+            pairing_node *child, *sibling;
+
+            pairing_node(T v) : v(v), child(nullptr), sibling(nullptr) {}
+        };
+
+        int64_t heap_size;
+        pairing_node* heap_root;
+        node_pool<pairing_node> pool;
+        Compare compare;
+
+        pairing_node* link(pairing_node* a, pairing_node* b);
+        pairing_node* merge_pairs(pairing_node* first);
+
+        template <typename F> void preorder(F fn) const;
+    public:
+        pairing_heap(Compare compare = Compare());
+        pairing_heap(const pairing_heap& copy);
+        pairing_heap(pairing_heap&& other);
+
+        ~pairing_heap();
+
+        pairing_heap& operator=(pairing_heap copy);
+
+        void insert(T value);
+
+        T push_pop(T value);
+
+        void meld(pairing_heap& other);
+        void merge(pairing_heap&& other);
+
+        T pop();
+        T root() const;
+        int64_t search(T value) const;
+        void reserve(int64_t capacity);
+        void clear();
+        void swap(pairing_heap& other);
+
+        int64_t size() const;
+        int64_t depth() const;
+        bool is_empty() const;
+
+        template <typename U, typename C>
+        friend std::ostream& operator<<(std::ostream& out, const pairing_heap<U,C>& heap);
+};
+
+template <typename T> using pairing_max_heap = pairing_heap<T, std::greater<T>>;
+template <typename T> using pairing_min_heap = pairing_heap<T, std::less<T>>;
+
+// Makes the root that loses the comparison the first child of the other.
+template <typename T, typename Compare>
+typename pairing_heap<T,Compare>::pairing_node* pairing_heap<T,Compare>::link(pairing_node* a,
+                                                                              pairing_node* b) {
+    if (a == nullptr) return b;
+    if (b == nullptr) return a;
+
+    if (this->compare(b->v, a->v)) std::swap(a, b);
+
+    b->sibling = a->child;
+    a->child = b;
+
+    return a;
+}
+
+// Two-pass pairing. The first pass links adjacent siblings and threads
+// the results into a list in reverse; the second folds that list, which
+// combines the pairs from the rightmost one back to the leftmost.
+template <typename T, typename Compare>
+typename pairing_heap<T,Compare>::pairing_node* pairing_heap<T,Compare>::merge_pairs(pairing_node* first) {
+    pairing_node* pairs = nullptr;
+
+    while (first != nullptr) {
+        pairing_node *a = first,
+                     *b = first->sibling;
+
+        if (b == nullptr) {
+            a->sibling = pairs;
+            pairs = a;
+            break;
+        }
+
+        first = b->sibling;
+        a->sibling = b->sibling = nullptr;
+
+        pairing_node* linked = this->link(a, b);
+        linked->sibling = pairs;
+        pairs = linked;
+    }
+
+    pairing_node* result = nullptr;
+
+    while (pairs != nullptr) {
+        pairing_node* next = pairs->sibling;
+        pairs->sibling = nullptr;
+
+        result = this->link(result, pairs);
+        pairs = next;
+    }
+
+    return result;
+}
+
+// Calls fn on every value, each node before its children and its
+// children before its later siblings.
+template <typename T, typename Compare> template <typename F>
+void pairing_heap<T,Compare>::preorder(F fn) const {
+    vector<pairing_node*> pending;
+
+    if (this->heap_root != nullptr) pending.push_back(this->heap_root);
+
+    while (!pending.is_empty()) {
+        pairing_node* node = pending.pop_back();
+
+        fn(node->v);
+
+        if (node->sibling != nullptr) pending.push_back(node->sibling);
+        if (node->child != nullptr) pending.push_back(node->child);
+    }
+}
+
+template <typename T, typename Compare>
+pairing_heap<T,Compare>::pairing_heap(Compare compare) : heap_size(0), heap_root(nullptr),
+                                                         compare(compare) {}
+
+template <typename T, typename Compare>
+pairing_heap<T,Compare>::pairing_heap(const pairing_heap& copy) : heap_size(0), heap_root(nullptr),
+                                                                  compare(copy.compare) {
+    vector<pairing_node*> pending;
+
+    if (copy.heap_root != nullptr) pending.push_back(copy.heap_root);
+
+    while (!pending.is_empty()) {
+        pairing_node* node = pending.pop_back();
+
+        this->insert(node->v);
+
+        if (node->child != nullptr) pending.push_back(node->child);
+        if (node->sibling != nullptr) pending.push_back(node->sibling);
+    }
+}
+
+template <typename T, typename Compare>
+pairing_heap<T,Compare>::pairing_heap(pairing_heap&& other) : heap_size(0), heap_root(nullptr),
+                                                              compare(other.compare) {
+    this->swap(other);
+}
+
+template <typename T, typename Compare>
+pairing_heap<T,Compare>::~pairing_heap() {
+    this->clear();
+}
+
+template <typename T, typename Compare>
+pairing_heap<T,Compare>& pairing_heap<T,Compare>::operator=(pairing_heap copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T, typename Compare>
+void pairing_heap<T,Compare>::insert(T value) {
+    this->heap_root = this->link(this->heap_root, this->pool.acquire(value));
+    ++this->heap_size;
+}
+
+// Reuses the root node for the new value instead of releasing it and
+// acquiring another.
+template <typename T, typename Compare>
+T pairing_heap<T,Compare>::push_pop(T value) {
+    if (this->is_empty() || !this->compare(this->heap_root->v, value)) {
+        return value;
+    }
+
+    pairing_node* top = this->heap_root;
+    T v = top->v;
+
+    this->heap_root = this->merge_pairs(top->child);
+
+    top->v = value;
+    top->child = nullptr;
+
+    this->heap_root = this->link(this->heap_root, top);
+
+    return v;
+}
+
+// Moves every element of other into this heap in O(1); other is left empty.
+template <typename T, typename Compare>
+void pairing_heap<T,Compare>::meld(pairing_heap& other) {
+    if (this == &other || other.is_empty())
+        return;
+
+    this->pool.absorb(other.pool);
+    this->heap_root = this->link(this->heap_root, other.heap_root);
+    this->heap_size += other.heap_size;
+
+    other.heap_root = nullptr;
+    other.heap_size = 0;
+}
+
+template <typename T, typename Compare>
+void pairing_heap<T,Compare>::merge(pairing_heap&& other) {
+    this->meld(other);
+}
+
+template <typename T, typename Compare>
+T pairing_heap<T,Compare>::pop() {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    pairing_node* top = this->heap_root;
+    T v = top->v;
+
+    this->heap_root = this->merge_pairs(top->child);
+    this->pool.release(top);
+
+    --this->heap_size;
+
+    return v;
+}
+
+template <typename T, typename Compare>
+T pairing_heap<T,Compare>::root() const {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    return this->heap_root->v;
+}
+
+// Returns the preorder position of the value, or -1 if it is not in the
+// heap.
+template <typename T, typename Compare>
+int64_t pairing_heap<T,Compare>::search(T value) const {
+    int64_t position = 0,
+            found = -1;
+
+    this->preorder([&](const T& v) {
+        if (found < 0 && v == value) found = position;
+        ++position;
+    });
+
+    return found;
+}
+
+template <typename T, typename Compare>
+void pairing_heap<T,Compare>::reserve(int64_t capacity) {
+    this->pool.reserve(capacity);
+}
+
+template <typename T, typename Compare>
+void pairing_heap<T,Compare>::clear() {
+    if (!std::is_trivially_destructible<T>::value) {
+        vector<pairing_node*> pending;
+
+        if (this->heap_root != nullptr) pending.push_back(this->heap_root);
+
+        while (!pending.is_empty()) {
+            pairing_node* node = pending.pop_back();
+
+            if (node->child != nullptr) pending.push_back(node->child);
+            if (node->sibling != nullptr) pending.push_back(node->sibling);
+
+            node->~pairing_node();
+        }
+    }
+
+    this->pool.release_all();
+    this->heap_root = nullptr;
+    this->heap_size = 0;
+}
+
+template <typename T, typename Compare>
+void pairing_heap<T,Compare>::swap(pairing_heap& other) {
+    std::swap(this->heap_size, other.heap_size);
+    std::swap(this->heap_root, other.heap_root);
+    std::swap(this->compare, other.compare);
+    this->pool.swap(other.pool);
+}
+
+template <typename T, typename Compare>
+int64_t pairing_heap<T,Compare>::size() const { return this->heap_size; }
+
+// Number of levels in the multiway tree; O(n), unlike the array heaps.
+template <typename T, typename Compare>
+int64_t pairing_heap<T,Compare>::depth() const {
+    int64_t max_depth = 0;
+    vector<pairing_node*> nodes;
+    vector<int64_t> depths;
+
+    if (this->heap_root != nullptr) {
+        nodes.push_back(this->heap_root);
+        depths.push_back(1);
+    }
+
+    while (!nodes.is_empty()) {
+        pairing_node* node = nodes.pop_back();
+        int64_t d = depths.pop_back();
+
+        max_depth = MAX(max_depth, d);
+
+        if (node->child != nullptr) {
+            nodes.push_back(node->child);
+            depths.push_back(d+1);
+        }
+
+        if (node->sibling != nullptr) {
+            nodes.push_back(node->sibling);
+            depths.push_back(d);
+        }
+    }
+
+    return max_depth;
+}
+
+template <typename T, typename Compare>
+bool pairing_heap<T,Compare>::is_empty() const { return (this->heap_root == nullptr); }
+
+template <typename T, typename Compare>
+std::ostream& operator<<(std::ostream& out, const pairing_heap<T,Compare>& heap) {
+    heap.preorder([&out](const T& v) { out << "<" << v << ">"; });
+
+    return out;
+}
+
+template <typename T, typename Compare>
+std::ostream& operator<<(std::ostream& out, const pairing_heap<T,Compare>* heap) {
+    return out << *heap;
+}
+
+#endif
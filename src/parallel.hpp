@@ -0,0 +1,145 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#pragma once
+#include <stdint.h>
+#include <utility>
+#include "list.hpp"
+#include "rb_tree.hpp"
+#include "set.hpp"
+#include "thread_pool.hpp"
+#include "MACROS.hpp"
+
+// Container algorithms split across a thread_pool. A subtree is forked
+// into its two children down to split_depth levels below the root, which
+// gives about 2^split_depth pieces; below that each piece runs serially.
+// The default asks for eight pieces per thread, so that stealing can
+// even out subtrees of different sizes.
+inline int64_t split_depth(const thread_pool& pool) {
+    return log2(8 * pool.threads());
+}
+
+template <typename T>
+void parallel_inorder_traversal(thread_pool& pool, rb_node<T>* node, list<T>& out, int64_t depth) {
+    if (node == nullptr)
+        return;
+
+    if (depth <= 0) {
+        list<T>* serial = &out;
+        inorder_traversal(node, serial);
+        return;
+    }
+
+    list<T> right;
+    task_group group(pool);
+
+    group.spawn([&pool, node, &right, depth]() {
+        parallel_inorder_traversal(pool, node->right(), right, depth - 1);
+    });
+
+    parallel_inorder_traversal(pool, node->left(), out, depth - 1);
+    out.push_back(node->value());
+
+    group.sync();
+
+    // The right half was built in its own list; append links it in O(1).
+    out.append(std::move(right));
+}
+
+template <typename T, typename Pool>
+list<T> parallel_inorder_traversal(thread_pool& pool, const rb_tree<T,Pool>& tree) {
+    list<T> traversal;
+
+    parallel_inorder_traversal(pool, tree.root(), traversal, split_depth(pool));
+
+    return traversal;
+}
+
+// Folds fn(value) over every value of the subtree with combine, which
+// must be associative; identity is its neutral element. Values are
+// combined in order.
+template <typename T, typename R, typename F, typename Op>
+R parallel_reduce(thread_pool& pool, rb_node<T>* node, R identity, F fn, Op combine, int64_t depth) {
+    if (node == nullptr)
+        return identity;
+
+    if (depth <= 0) {
+        R left = parallel_reduce(pool, node->left(), identity, fn, combine, 0),
+          right = parallel_reduce(pool, node->right(), identity, fn, combine, 0);
+
+        return combine(combine(left, fn(node->value_ref())), right);
+    }
+
+    R right = identity;
+    task_group group(pool);
+
+    group.spawn([&]() { right = parallel_reduce(pool, node->right(), identity, fn, combine, depth - 1); });
+
+    R left = parallel_reduce(pool, node->left(), identity, fn, combine, depth - 1);
+
+    group.sync();
+
+    return combine(combine(left, fn(node->value_ref())), right);
+}
+
+template <typename T, typename Pool, typename R, typename F, typename Op>
+R parallel_reduce(thread_pool& pool, const rb_tree<T,Pool>& tree, R identity, F fn, Op combine) {
+    return parallel_reduce(pool, tree.root(), identity, fn, combine, split_depth(pool));
+}
+
+// Fork for rb_tree's set algebra: the right half is spawned onto pool
+// while the calling thread runs the left one.
+struct pool_fork {
+    thread_pool* pool;
+
+    template <typename L, typename R> void operator()(L& left, R& right) const {
+        task_group group(*this->pool);
+
+        group.spawn([&right]() { right(); });
+        left();
+
+        group.sync();
+    }
+};
+
+template <typename T, typename Pool>
+set<T,rb_tree<T,Pool>> set_union(thread_pool& pool, const set<T,rb_tree<T,Pool>>& w,
+                                 const set<T,rb_tree<T,Pool>>& v) {
+    set<T,rb_tree<T,Pool>> u = w;
+
+    u.unite(set<T,rb_tree<T,Pool>>(v), pool_fork{ &pool }, split_depth(pool));
+
+    return u;
+}
+
+template <typename T, typename Pool>
+set<T,rb_tree<T,Pool>> set_intersection(thread_pool& pool, const set<T,rb_tree<T,Pool>>& w,
+                                        const set<T,rb_tree<T,Pool>>& v) {
+    set<T,rb_tree<T,Pool>> i = w;
+
+    i.intersect(v, pool_fork{ &pool }, split_depth(pool));
+
+    return i;
+}
+
+template <typename T, typename Pool>
+set<T,rb_tree<T,Pool>> set_difference(thread_pool& pool, const set<T,rb_tree<T,Pool>>& w,
+                                      const set<T,rb_tree<T,Pool>>& v) {
+    set<T,rb_tree<T,Pool>> d = w;
+
+    d.subtract(v, pool_fork{ &pool }, split_depth(pool));
+
+    return d;
+}
+
+template <typename T, typename Pool>
+set<T,rb_tree<T,Pool>> symmetric_difference(thread_pool& pool, const set<T,rb_tree<T,Pool>>& w,
+                                            const set<T,rb_tree<T,Pool>>& v) {
+    set<T,rb_tree<T,Pool>> d = w;
+
+    d.symmetric_subtract(set<T,rb_tree<T,Pool>>(v), pool_fork{ &pool }, split_depth(pool));
+
+    return d;
+}
+
+#endif
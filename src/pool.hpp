@@ -0,0 +1,232 @@
+#ifndef POOL_H
+#define POOL_H
+
+#pragma once
+#include <assert.h>
+#include <new>
+#include <stdint.h>
+#include <utility>
+
+// Slab allocator for fixed-size nodes. Nodes are carved out of slabs that
+// double in size up to max_slab slots; released nodes go onto an intrusive
+// free list and are handed out again before any fresh slab space is used.
+//
+// release_all() and the destructor free every slab at once without
+// visiting the nodes, so the owner must destroy any live node whose type
+// is not trivially destructible before calling them.
+template <typename T> class node_pool {
+    private:
+        static constexpr int64_t max_slab = 1 << 16;
+
+        union slot {
+            slot* next_free;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        struct slab {
+            slab* next;
+            slot* slots;
+        };
+
+        slab *slabs, *last_slab;
+        slot *free_list, *free_tail, *cursor, *slab_end;
+        int64_t slab_size, live, allocated, owned;
+
+        void add_slab(int64_t count);
+        void grow();
+        void recycle(slot* first, slot* last);
+    public:
+        node_pool(int64_t first_slab = 64);
+        node_pool(const node_pool<T>& copy) = delete;
+        node_pool(node_pool<T>&& other);
+
+        ~node_pool();
+
+        node_pool<T>& operator=(const node_pool<T>& copy) = delete;
+        node_pool<T>& operator=(node_pool<T>&& other);
+
+        template <typename... Args> T* acquire(Args&&... args);
+        void release(T* node);
+        void release_all();
+        void reserve(int64_t capacity);
+
+        void absorb(node_pool<T>& other);
+        void swap(node_pool<T>& other);
+
+        int64_t size() const;
+        int64_t slab_allocations() const;
+};
+
+// The new slab's slots become the cursor range; the caller sees to any
+// slots left in the old one.
+template <typename T> void node_pool<T>::add_slab(int64_t count) {
+    slab* s = new slab{ nullptr, new slot[count] };
+
+    if (this->last_slab == nullptr) this->slabs = s;
+    else this->last_slab->next = s;
+
+    this->last_slab = s;
+    this->cursor = s->slots;
+    this->slab_end = s->slots + count;
+    this->owned += count;
+    ++this->allocated;
+}
+
+template <typename T> void node_pool<T>::grow() {
+    this->add_slab(this->slab_size);
+
+    if (this->slab_size < max_slab) this->slab_size *= 2;
+}
+
+// Puts the never used slots [first, last) on the free list.
+template <typename T> void node_pool<T>::recycle(slot* first, slot* last) {
+    for (slot* s = first; s != last; s++) {
+        s->next_free = this->free_list;
+        this->free_list = s;
+
+        if (this->free_tail == nullptr) this->free_tail = s;
+    }
+}
+
+template <typename T> node_pool<T>::node_pool(int64_t first_slab) : slabs(nullptr), last_slab(nullptr),
+                                                                    free_list(nullptr), free_tail(nullptr),
+                                                                    cursor(nullptr),
+                                                                    slab_end(nullptr), slab_size(first_slab),
+                                                                    live(0), allocated(0), owned(0) {
+    assert(first_slab > 0);
+}
+
+template <typename T> node_pool<T>::node_pool(node_pool<T>&& other) : node_pool(other.slab_size) {
+    this->swap(other);
+}
+
+template <typename T> node_pool<T>::~node_pool() {
+    this->release_all();
+}
+
+template <typename T> node_pool<T>& node_pool<T>::operator=(node_pool<T>&& other) {
+    this->release_all();
+    this->swap(other);
+    return *this;
+}
+
+template <typename T> template <typename... Args> T* node_pool<T>::acquire(Args&&... args) {
+    slot* s;
+
+    if (this->free_list != nullptr) {
+        s = this->free_list;
+        this->free_list = s->next_free;
+
+        if (this->free_list == nullptr) this->free_tail = nullptr;
+    } else {
+        if (this->cursor == this->slab_end) this->grow();
+        s = this->cursor++;
+    }
+
+    ++this->live;
+
+    return new (s->storage) T(std::forward<Args>(args)...);
+}
+
+template <typename T> void node_pool<T>::release(T* node) {
+    if (node == nullptr)
+        return;
+
+    node->~T();
+
+    slot* s = reinterpret_cast<slot*>(node);
+    s->next_free = this->free_list;
+    this->free_list = s;
+
+    if (this->free_tail == nullptr) this->free_tail = s;
+
+    --this->live;
+}
+
+template <typename T> void node_pool<T>::release_all() {
+    while (this->slabs != nullptr) {
+        slab* next = this->slabs->next;
+
+        delete[] this->slabs->slots;
+        delete this->slabs;
+
+        this->slabs = next;
+    }
+
+    this->last_slab = nullptr;
+    this->free_list = this->free_tail = this->cursor = this->slab_end = nullptr;
+    this->live = this->owned = 0;
+}
+
+// Makes room for capacity nodes in all, live ones included, so that
+// acquiring up to that many allocates nothing. What is missing comes in
+// one slab of exactly that size.
+template <typename T> void node_pool<T>::reserve(int64_t capacity) {
+    if (capacity <= this->owned)
+        return;
+
+    this->recycle(this->cursor, this->slab_end);
+    this->add_slab(capacity - this->owned);
+}
+
+// Takes over the other pool's slabs, so nodes handed out by it can later
+// be released into this pool, and keeps every slot it had spare: the two
+// free lists are joined through their tails, and of the two unused slab
+// tails the larger stays the cursor while the smaller goes on the free
+// list. A slot goes on the free list that way at most once, so repeated
+// absorbing costs O(1) amortized and loses nothing.
+template <typename T> void node_pool<T>::absorb(node_pool<T>& other) {
+    if (other.slabs == nullptr)
+        return;
+
+    if (this->last_slab == nullptr) {
+        this->swap(other);
+        return;
+    }
+
+    this->last_slab->next = other.slabs;
+    this->last_slab = other.last_slab;
+
+    if (other.free_list != nullptr) {
+        if (this->free_list == nullptr) this->free_list = other.free_list;
+        else this->free_tail->next_free = other.free_list;
+
+        this->free_tail = other.free_tail;
+    }
+
+    if (other.slab_end - other.cursor > this->slab_end - this->cursor) {
+        std::swap(this->cursor, other.cursor);
+        std::swap(this->slab_end, other.slab_end);
+    }
+
+    this->recycle(other.cursor, other.slab_end);
+
+    this->live += other.live;
+    this->allocated += other.allocated;
+    this->owned += other.owned;
+
+    other.slabs = other.last_slab = nullptr;
+    other.free_list = other.free_tail = other.cursor = other.slab_end = nullptr;
+    other.live = other.owned = 0;
+}
+
+template <typename T> void node_pool<T>::swap(node_pool<T>& other) {
+    std::swap(this->slabs, other.slabs);
+    std::swap(this->last_slab, other.last_slab);
+    std::swap(this->free_list, other.free_list);
+    std::swap(this->free_tail, other.free_tail);
+    std::swap(this->cursor, other.cursor);
+    std::swap(this->slab_end, other.slab_end);
+    std::swap(this->slab_size, other.slab_size);
+    std::swap(this->live, other.live);
+    std::swap(this->allocated, other.allocated);
+    std::swap(this->owned, other.owned);
+}
+
+// Number of nodes currently handed out.
+template <typename T> int64_t node_pool<T>::size() const { return this->live; }
+
+// Number of times the pool has gone to the system allocator.
+template <typename T> int64_t node_pool<T>::slab_allocations() const { return this->allocated; }
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#pragma once
+#include <assert.h>
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include "vector.hpp"
+#include "MACROS.hpp"
+
+// Min heap for integer keys that are popped in non-decreasing order, such
+// as the timestamps of an event loop. Every key inserted must be at least
+// the last key popped.
+//
+// Keys are kept in buckets by the highest bit in which they differ from
+// the last popped key: bucket 0 holds keys equal to it and bucket b holds
+// keys whose highest differing bit is b-1. pop() serves bucket 0; when it
+// is empty, the lowest non-empty bucket is emptied into lower buckets
+// around its minimum. A key only ever moves to a lower bucket, so each
+// one is touched at most once per bit for O(log U) amortized work and no
+// key comparisons beyond finding a bucket minimum.
+template <typename K> class radix_heap {
+    static_assert(std::is_integral<K>::value, "A radix heap needs integral keys");
+
+    private:
+        typedef typename std::make_unsigned<K>::type U;
+
+        static constexpr int64_t bits = std::numeric_limits<U>::digits;
+
+        vector<K> buckets[bits + 1];
+        int64_t heap_size;
+        U last;
+
+        static U order(K key);
+        int64_t bucket_of(K key) const;
+        void redistribute();
+    public:
+        radix_heap() : heap_size(0), last(0) {}
+
+        ~radix_heap() {}
+
+        void insert(K key);
+
+        K pop();
+        K root();
+        void clear();
+
+        int64_t size() const;
+        bool is_empty() const;
+};
+
+// Maps a key to an unsigned value with the same ordering; signed keys have
+// their sign bit flipped so that negative keys sort below positive ones.
+template <typename K> typename radix_heap<K>::U radix_heap<K>::order(K key) {
+    U u = static_cast<U>(key);
+
+    if (std::is_signed<K>::value)
+        u ^= (U(1) << (bits - 1));
+
+    return u;
+}
+
+template <typename K> int64_t radix_heap<K>::bucket_of(K key) const {
+    return bit_width(static_cast<uint64_t>(order(key) ^ this->last));
+}
+
+template <typename K> void radix_heap<K>::redistribute() {
+    int64_t b = 1;
+
+    while (this->buckets[b].is_empty()) ++b;
+
+    vector<K>& source = this->buckets[b];
+    U minimum = order(source[0]);
+
+    for (int64_t k = 1; k < source.size(); k++) {
+        minimum = MIN(minimum, order(source[k]));
+    }
+
+    this->last = minimum;
+
+    for (int64_t k = 0; k < source.size(); k++) {
+        this->buckets[this->bucket_of(source[k])].push_back(source[k]);
+    }
+
+    // Keep the bucket's buffer for later keys.
+    source.clear();
+}
+
+template <typename K> void radix_heap<K>::insert(K key) {
+    assert(order(key) >= this->last);
+
+    this->buckets[this->bucket_of(key)].push_back(key);
+    ++this->heap_size;
+}
+
+template <typename K> K radix_heap<K>::pop() {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    if (this->buckets[0].is_empty())
+        this->redistribute();
+
+    --this->heap_size;
+
+    return this->buckets[0].pop_back();
+}
+
+template <typename K> K radix_heap<K>::root() {
+    if (this->is_empty())
+        throw std::out_of_range("The heap is empty");
+
+    if (this->buckets[0].is_empty())
+        this->redistribute();
+
+    return this->buckets[0].back();
+}
+
+template <typename K> void radix_heap<K>::clear() {
+    for (int64_t b = 0; b <= bits; b++) {
+        this->buckets[b].clear();
+    }
+
+    this->heap_size = 0;
+    this->last = 0;
+}
+
+template <typename K> int64_t radix_heap<K>::size() const { return this->heap_size; }
+
+template <typename K> bool radix_heap<K>::is_empty() const { return (this->heap_size == 0); }
+
+#endif
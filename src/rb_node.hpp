@@ -3,16 +3,21 @@
 
 #pragma once
 #include <iostream>
+#include <stdint.h>
 
 #define node_color(N) ( N == nullptr ? BLACK : N->color() )
 
 enum rb_color_t { BLACK, RED };
 
+// The color is kept in the low bit of the parent pointer, which is
+// always zero since nodes are at least pointer aligned. That saves the
+// padded color field: a node is the value plus three pointers, 32 bytes
+// for an int and for a pair<int,int>.
 template <typename T> class rb_node {
     private:
         T v;
-        rb_color_t c;
-        rb_node<T> *left_node, *right_node, *parent_node;
+        rb_node<T> *left_node, *right_node;
+        uintptr_t parent_color;
     public:
         rb_node(T v,
                 rb_node<T> *l = nullptr, 
@@ -23,6 +28,7 @@ template <typename T> class rb_node {
 
         void value(T v);
         T value() const;
+        const T& value_ref() const;
 
         void right(rb_node<T>* right);
         rb_node<T>* right() const;
@@ -58,15 +64,14 @@ template <typename T> class rb_node {
 template <typename T> rb_node<T>::rb_node(T value,
                                           rb_node<T>* l,
                                           rb_node<T>* r,
-                                          rb_node<T>* p) {
-    this->v = value;
-    this->left(l);
-    this->right(r);
-    this->parent(p);
+                                          rb_node<T>* p) : v(value), left_node(l), right_node(r),
+                                                           parent_color(reinterpret_cast<uintptr_t>(p)) {
+    static_assert(alignof(rb_node<T>) >= 2, "The color bit needs pointer alignment");
 }
 
 template <typename T> void rb_node<T>::value(T v) { this->v = v; }
 template <typename T> T rb_node<T>::value() const { return this->v; }
+template <typename T> const T& rb_node<T>::value_ref() const { return this->v; }
 
 template <typename T> void rb_node<T>::right(rb_node<T>* right) {
     this->right_node = right;
@@ -85,30 +90,35 @@ template <typename T> rb_node<T>* rb_node<T>::left() const {
 }
 
 template <typename T> void rb_node<T>::parent(rb_node<T>* parent) {
-    this->parent_node = parent;
+    this->parent_color = reinterpret_cast<uintptr_t>(parent) | (this->parent_color & 1);
 }
 
 template <typename T> rb_node<T>* rb_node<T>::parent() const {
-    return this->parent_node;
+    return reinterpret_cast<rb_node<T>*>(this->parent_color & ~static_cast<uintptr_t>(1));
 }
 
 template <typename T> bool rb_node<T>::is_right_node() const {
-    return (this->parent_node == nullptr ? false : (this->parent()->right() == this));
+    return (this->parent() == nullptr ? false : (this->parent()->right() == this));
 }
 
 template <typename T> rb_node<T>* rb_node<T>::grandparent() const {
-    return (this->parent_node == nullptr ? nullptr : this->parent_node->parent());
+    rb_node<T>* p = this->parent();
+
+    return (p == nullptr ? nullptr : p->parent());
 }
 
 template <typename T> rb_node<T>* rb_node<T>::sibling() const {
-    return (this->parent_node == nullptr ? nullptr : 
-            this->is_right_node() ? this->parent_node->left() : 
-                                    this->parent_node->right());
+    rb_node<T>* p = this->parent();
+
+    return (p == nullptr ? nullptr : 
+            this->is_right_node() ? p->left() : 
+                                    p->right());
 }
 
 template <typename T> rb_node<T>* rb_node<T>::uncle() const {
-    return (this->parent_node == nullptr ? nullptr
-                                         : this->parent_node->sibling());
+    rb_node<T>* p = this->parent();
+
+    return (p == nullptr ? nullptr : p->sibling());
 }
 
 template <typename T> void rb_node<T>::child(rb_node<T>* node, int D) {
@@ -124,11 +134,18 @@ template <typename T> bool rb_node<T>::operator==(rb_node<T> node) const {
     return (this->value() == node.value());
 }
 
-template <typename T> void rb_node<T>::color(rb_color_t c) { this->c = c; }
-template <typename T> rb_color_t rb_node<T>::color() const { return this->c; }
+template <typename T> void rb_node<T>::color(rb_color_t c) {
+    this->parent_color = (this->parent_color & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(c);
+}
+
+template <typename T> rb_color_t rb_node<T>::color() const {
+    return static_cast<rb_color_t>(this->parent_color & 1);
+}
 
+// Clears the links but keeps the color.
 template <typename T> void rb_node<T>::isolate() {
-    this->parent_node = this->left_node = this->right_node = nullptr;
+    this->left_node = this->right_node = nullptr;
+    this->parent_color &= 1;
 }
 
 template <typename T> int rb_node<T>::children() {
@@ -163,6 +180,15 @@ template <typename T> rb_node<T>* minimum(rb_node<T>* node) {
     return current;
 }
 
+template <typename T> rb_node<T>* maximum(rb_node<T>* node) {
+    rb_node<T>* current = node;
+
+    while (current->right() != nullptr) 
+        current = current->right();
+    
+    return current;
+}
+
 template <typename T> rb_node<T>* inorder_successor(rb_node<T>* node) {
     if (node->right() != nullptr)
         return minimum(node->right());
@@ -171,7 +197,22 @@ template <typename T> rb_node<T>* inorder_successor(rb_node<T>* node) {
                *current = node;
 
     while (parent != nullptr && current->is_right_node()) {
-        node = parent;
+        current = parent;
+        parent = parent->parent();
+    }
+
+    return parent;
+}
+
+template <typename T> rb_node<T>* inorder_predecessor(rb_node<T>* node) {
+    if (node->left() != nullptr)
+        return maximum(node->left());
+
+    rb_node<T> *parent = node->parent(), 
+               *current = node;
+
+    while (parent != nullptr && !current->is_right_node()) {
+        current = parent;
         parent = parent->parent();
     }
 
@@ -3,124 +3,302 @@
 
 #pragma once
 #include "deque.hpp"
+#include "generator.hpp"
 #include "rb_node.hpp"
 #include "list.hpp"
+#include "pool.hpp"
+#include "stack.hpp"
+#include <cstddef>
+#include <iterator>
 #include <stdint.h>
+#include <type_traits>
+#include <utility>
 
-template <typename T> class rb_tree {
+template <typename T, typename Pool = node_pool<rb_node<T>>> class rb_tree;
+
+// Runs the two halves of a divide-and-conquer step one after the other.
+// parallel.hpp has one that forks them onto a thread_pool instead.
+struct serial_fork {
+    template <typename L, typename R> void operator()(L& left, R& right) const {
+        left();
+        right();
+    }
+};
+
+// In-order bidirectional iterator. Steps follow inorder_successor and
+// inorder_predecessor through the parent links, so walking the tree
+// allocates nothing. Elements are read-only, since changing one in place
+// could break the ordering. The end position is a null node; the tree's
+// root is remembered so that decrementing end() reaches the maximum.
+template <typename T> class rb_tree_iterator {
+    private:
+        rb_node<T>* node;
+        rb_node<T>* const* root;
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        rb_tree_iterator(rb_node<T>* node = nullptr, rb_node<T>* const* root = nullptr) : node(node),
+                                                                                         root(root) {}
+
+        reference operator*() const { return this->node->value_ref(); }
+        pointer operator->() const { return &this->node->value_ref(); }
+
+        rb_tree_iterator& operator++() {
+            this->node = inorder_successor(this->node);
+            return *this;
+        }
+
+        rb_tree_iterator operator++(int) {
+            rb_tree_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        rb_tree_iterator& operator--() {
+            this->node = (this->node == nullptr ? maximum(*this->root) : inorder_predecessor(this->node));
+            return *this;
+        }
+
+        rb_tree_iterator operator--(int) {
+            rb_tree_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        friend bool operator==(const rb_tree_iterator& a, const rb_tree_iterator& b) { return a.node == b.node; }
+        friend bool operator!=(const rb_tree_iterator& a, const rb_tree_iterator& b) { return a.node != b.node; }
+
+        rb_node<T>* node_ptr() const { return this->node; }
+};
+
+// Red-black tree. Equal values are all kept, each to the right of the
+// ones before it; set and map search before inserting.
+//
+// The tree owns its nodes. They come from Pool, a removed node goes back
+// to it to be reused by the next insert, and clear() and the destructor
+// return every slab at once. Any Pool with node_pool's acquire, release,
+// release_all, absorb and swap will do.
+//
+// unite, intersect, subtract and symmetric_subtract combine two trees
+// with split and join (Blelloch, Ferizovic and Sun), in
+// O(m log(n/m + 1)) for trees of m <= n values, and reuse the nodes they
+// are given instead of inserting. Their two recursive halves are
+// independent, so a Fork may run them in parallel down to depth levels.
+// Values that compare equivalent are taken to be the same element.
+template <typename T, typename Pool> class rb_tree {
     private:
         int64_t tree_size;
         rb_node<T> *tree_root;
+        Pool pool;
+
+        static void rotate(rb_node<T>* node, bool right, rb_node<T>*& root);
+        static bool maintain_properties_insertion(rb_node<T>* node, rb_node<T>*& root);
+        void maintain_properties_deletion(rb_node<T>* node, rb_node<T>* parent);
+
+        void link(rb_node<T>* node);
+        void transplant(rb_node<T>* O, rb_node<T>* N);
+        rb_node<T>* clone(const rb_node<T>* node, rb_node<T>* parent);
+
+        template <typename It>
+        rb_node<T>* build(It& first, It last, int64_t n, int64_t depth, int64_t red_depth,
+                          rb_node<T>* parent, bool unique);
+
+        // A detached subtree and its black height: the number of black
+        // nodes on every path from its root down to a null child.
+        struct subtree {
+            rb_node<T>* root;
+            int64_t height;
+        };
+
+        // Subtrees the set algebra leaves out, linked through their roots'
+        // parent pointers until they are released. Parallel halves each
+        // keep their own, so nothing touches the pool until the end.
+        struct dropped {
+            rb_node<T> *head, *tail;
+
+            dropped() : head(nullptr), tail(nullptr) {}
+
+            void push(rb_node<T>* root);
+            void append(dropped& other);
+        };
+
+        static int64_t black_height(rb_node<T>* node);
+        static subtree detach(rb_node<T>* node, int64_t height);
+
+        static subtree join(subtree left, rb_node<T>* node, subtree right);
+        static subtree join(subtree left, subtree right);
+        static void split(subtree tree, const T& key, subtree& left, subtree& right, rb_node<T>*& found);
+
+        template <typename Fork, typename L, typename R>
+        static void both(Fork& fork, int64_t depth, L left, R right);
+
+        template <typename Fork>
+        static subtree unite(subtree a, subtree b, dropped& out, Fork& fork, int64_t depth);
+        template <typename Fork>
+        static subtree intersect(subtree a, const rb_node<T>* b, dropped& out, Fork& fork, int64_t depth);
+        template <typename Fork>
+        static subtree subtract(subtree a, const rb_node<T>* b, dropped& out, Fork& fork, int64_t depth);
+        template <typename Fork>
+        static subtree symmetric_subtract(subtree a, subtree b, dropped& out, Fork& fork, int64_t depth);
+
+        subtree take_root();
+        void adopt(subtree tree, int64_t size, dropped& out);
+
+        rb_node<T>* lower(const T& value) const;
+        rb_node<T>* upper(const T& value) const;
+    public:
+        typedef rb_tree_iterator<T> iterator;
+        typedef rb_tree_iterator<T> const_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-        void rotate(rb_node<T>* node, bool right);
-        void maintain_properties_insertion(rb_node<T>* node);
-        void maintain_properties_deletion(rb_node<T>* node);
+        rb_tree();
+        rb_tree(const rb_tree& copy);
+        rb_tree(rb_tree&& other);
 
-        void replace_node_child(rb_node<T>* P, rb_node<T>* O, rb_node<T>* N);
-        rb_node<T>* non_double_removal(rb_node<T>* node);
-    public:
-        rb_tree(rb_node<T>* root = nullptr);
+        ~rb_tree();
+
+        rb_tree& operator=(rb_tree copy);
+
+        template <typename It> static rb_tree from_sorted(It first, It last);
+        template <typename Range> static rb_tree from_sorted(const Range& range);
 
-        ~rb_tree() {}
+        template <typename It> void assign_sorted(It first, It last, bool unique = false);
 
-        void insert(T value);
-        void insert(rb_node<T>* node);
+        template <typename Fork = serial_fork>
+        void unite(rb_tree&& other, Fork fork = Fork(), int64_t depth = 0);
+        template <typename Fork = serial_fork>
+        void intersect(const rb_tree& other, Fork fork = Fork(), int64_t depth = 0);
+        template <typename Fork = serial_fork>
+        void subtract(const rb_tree& other, Fork fork = Fork(), int64_t depth = 0);
+        template <typename Fork = serial_fork>
+        void symmetric_subtract(rb_tree&& other, Fork fork = Fork(), int64_t depth = 0);
+
+        rb_node<T>* insert(T value);
 
         void remove(T value);
         void remove(rb_node<T>* node);
 
         rb_node<T>* search(T value) const;
+        rb_node<T>* find(T value) const;
         rb_node<T>* root() const;
 
+        iterator lower_bound(T value) const;
+        iterator upper_bound(T value) const;
+        std::pair<iterator,iterator> equal_range(T value) const;
+
+        rb_node<T>* floor(T value) const;
+        rb_node<T>* ceiling(T value) const;
+
+        template <typename F> void for_each_in_range(T lo, T hi, F fn) const;
+
         int64_t size() const;
 
         void clear();
-};
+        void swap(rb_tree& other);
 
-template <typename T> void rb_tree<T>::maintain_properties_insertion(rb_node<T>* node) {
-    rb_node<T> *P = node->parent(), 
-               *U = node->uncle(), 
-               *G = node->grandparent();
+        iterator begin() const;
+        iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
 
-    if (node_color(P) == BLACK)
-        return;
+        reverse_iterator rbegin() const;
+        reverse_iterator rend() const;
+};
 
-    // case 2: red parent, parent == root.
-    if (node_color(P) == RED && P == this->tree_root) {
-        P->color(BLACK); 
-    // case 3: red parent, and red uncle
-    } else if (node_color(P) == RED && node_color(U) == RED) {
-        // recolor parent & uncle red
-        // recolor grandparent black
-        // call maintain properties recursively on grandparent node
-        P->color(BLACK);
-        U->color(BLACK);
-        G->color(RED);
+// root is the root of the tree node is in, which rotations may replace.
+// Returns whether the fixup reached the root and turned it red, so that
+// blackening it again added a level to the black height.
+template <typename T, typename Pool>
+bool rb_tree<T,Pool>::maintain_properties_insertion(rb_node<T>* node, rb_node<T>*& root) {
+    rb_node<T>* P;
+
+    while ((P = node->parent()) != nullptr && node_color(P) == RED) {
+        // A red parent is never the root, so the grandparent exists.
+        rb_node<T> *G = P->parent();
+        int D = P->is_right_node();
+        rb_node<T> *U = G->child(1-D);
+
+        // red uncle: push the grandparent's black down a level and
+        // continue from the grandparent.
+        if (node_color(U) == RED) {
+            P->color(BLACK);
+            U->color(BLACK);
+            G->color(RED);
+
+            node = G;
+            continue;
+        }
 
-        this->maintain_properties_insertion(G);
-    } else if (node->is_right_node() != P->is_right_node()) {
-        bool nrc = node->is_right_node(), prc = P->is_right_node();
+        // black uncle, node on the inner side: rotate it to the outer side.
+        if (node == P->child(1-D)) {
+            rotate(P, D, root);
 
-        this->rotate(P, prc);
-        this->rotate(G, !prc);
+            node = P;
+            P = node->parent();
+        }
 
-        node->color(BLACK);
-        G->color(RED);
-    } else if (node_color(U) == BLACK && node_color(P) == RED &&
-               node->is_right_node() == P->is_right_node()) {
-        this->rotate(G, !node->is_right_node());
+        // black uncle, node on the outer side.
         P->color(BLACK);
         G->color(RED);
+        rotate(G, 1-D, root);
     }
-}
 
-template <typename T> void rb_tree<T>::maintain_properties_deletion(rb_node<T>* node) {
-    if (node_color(node) == BLACK) 
-        return;
+    bool grew = (root->color() == RED);
+    root->color(BLACK);
 
-    if (node == this->tree_root) {
-        node->color(BLACK);
-        return;
-    } 
+    return grew;
+}
 
-    rb_node<T>* sibling = node->sibling();
+// node took the place of a removed black node and is short one black; it
+// may be null, so its parent is passed along.
+template <typename T, typename Pool>
+void rb_tree<T,Pool>::maintain_properties_deletion(rb_node<T>* node, rb_node<T>* parent) {
+    while (node != this->tree_root && node_color(node) == BLACK) {
+        int D = (node == parent->right());
+        rb_node<T>* sibling = parent->child(1-D);
 
-    if (node_color(sibling) == RED) {
-        sibling->color(BLACK);
-        node->parent()->color(RED);
+        if (node_color(sibling) == RED) {
+            sibling->color(BLACK);
+            parent->color(RED);
 
-        this->rotate(node->parent(), node->is_right_node());
-        sibling = node->sibling();
-    }
+            rotate(parent, D, this->tree_root);
+            sibling = parent->child(1-D);
+        }
 
-    if (node_color(sibling->right()) == BLACK && 
-        node_color(sibling->left()) == BLACK) {
-        sibling->color(RED);
-    
-        if (node_color(node->parent()) == RED) {
-            node->parent()->color(BLACK);
-        } else {
-            maintain_properties_deletion(node->parent());
+        if (node_color(sibling->left()) == BLACK && node_color(sibling->right()) == BLACK) {
+            sibling->color(RED);
+
+            node = parent;
+            parent = node->parent();
+            continue;
         }
-    } else {
-        int D = node->is_right_node();
 
         if (node_color(sibling->child(1-D)) == BLACK) {
-            sibling->color(RED);
             sibling->child(D)->color(BLACK);
-            rotate(sibling, 1-D);
-            sibling = node->parent()->child(1-D);
-        }
+            sibling->color(RED);
 
-        sibling->color(node->parent()->color());
-        node->parent()->color(BLACK);
+            rotate(sibling, 1-D, this->tree_root);
+            sibling = parent->child(1-D);
+        }
 
+        sibling->color(parent->color());
+        parent->color(BLACK);
         sibling->child(1-D)->color(BLACK);
-        rotate(node->parent(), D);
+
+        rotate(parent, D, this->tree_root);
+        node = this->tree_root;
     }
+
+    if (node != nullptr)
+        node->color(BLACK);
 }
 
-template <typename T> void rb_tree<T>::rotate(rb_node<T>* N, bool dir) {
+template <typename T, typename Pool> void rb_tree<T,Pool>::rotate(rb_node<T>* N, bool dir, rb_node<T>*& root) {
     int D = static_cast<int>(dir);
 
     rb_node<T> *G = N->parent(),
@@ -140,114 +318,209 @@ template <typename T> void rb_tree<T>::rotate(rb_node<T>* N, bool dir) {
     N->parent(Y);
     Y->parent(G);
 
-    if (G == nullptr) { this->tree_root = Y; }
+    if (G == nullptr) { root = Y; }
     else { G->child(Y, N == G->right() ? 1 : 0); }
 }
 
-template <typename T> void rb_tree<T>::replace_node_child(rb_node<T>* P,
-                                                          rb_node<T>* O,
-                                                          rb_node<T>* N) {
-    if (O == nullptr)
-        return;
-
-    bool right = (O->is_right_node());
+// Puts N where O hangs from O's parent. O's own links are left alone.
+template <typename T, typename Pool> void rb_tree<T,Pool>::transplant(rb_node<T>* O, rb_node<T>* N) {
+    rb_node<T>* P = O->parent();
 
-    if (P == nullptr) 
+    if (P == nullptr)
         this->tree_root = N;
-    else if (right) 
-        P->right(N);
-    else 
-        P->left(N);
-    
+    else
+        P->child(N, O == P->right());
+
     if (N != nullptr)
         N->parent(P);
-
-    O->isolate();
 }
 
-template <typename T> rb_node<T>* rb_tree<T>::non_double_removal(rb_node<T>* node) {
+template <typename T, typename Pool>
+rb_node<T>* rb_tree<T,Pool>::clone(const rb_node<T>* node, rb_node<T>* parent) {
     if (node == nullptr)
         return nullptr;
 
-    rb_node<T>* moved = (node->right() != nullptr ? node->right() :
-                         node->left() != nullptr ? node->left() : nullptr);
+    rb_node<T>* copy = this->pool.acquire(node->value_ref(), nullptr, nullptr, parent);
 
-    this->replace_node_child(node->parent(), node, moved);
+    copy->color(node->color());
+    copy->left(this->clone(node->left(), copy));
+    copy->right(this->clone(node->right(), copy));
 
-    return moved;
+    return copy;
 }
 
-template <typename T> rb_tree<T>::rb_tree(rb_node<T>* root) : tree_root(root),
-                                                                              tree_size(0) {
-    if (tree_root != nullptr) 
-        ++this->tree_size;                                                   
+// Builds the n values from first on, in order, into a perfectly balanced
+// subtree whose root is at depth. All of its leaves end up on the last
+// level, red_depth, or the one above it, so coloring the last level red
+// and everything else black makes every black height agree. With unique,
+// a run of == values is taken once.
+template <typename T, typename Pool> template <typename It>
+rb_node<T>* rb_tree<T,Pool>::build(It& first, It last, int64_t n, int64_t depth, int64_t red_depth,
+                                   rb_node<T>* parent, bool unique) {
+    if (n == 0)
+        return nullptr;
+
+    int64_t left_size = (n - 1) / 2;
+
+    rb_node<T> *left = this->build(first, last, left_size, depth + 1, red_depth, nullptr, unique),
+               *node = this->pool.acquire(*first, left, nullptr, parent);
+
+    ++first;
+
+    if (unique) {
+        while (first != last && *first == node->value_ref()) ++first;
+    }
+
+    if (left != nullptr)
+        left->parent(node);
+
+    node->color(depth == red_depth && depth > 0 ? RED : BLACK);
+    node->right(this->build(first, last, n - 1 - left_size, depth + 1, red_depth, node, unique));
+
+    return node;
 }
 
-template <typename T> void rb_tree<T>::insert(rb_node<T>* node) {
-    if (node == nullptr)
-        return;
+template <typename T, typename Pool> rb_tree<T,Pool>::rb_tree() : tree_size(0), tree_root(nullptr) {}
+
+// Copies the shape and colors node for node, so no rebalancing is done.
+template <typename T, typename Pool> rb_tree<T,Pool>::rb_tree(const rb_tree& copy) : rb_tree() {
+    this->tree_root = this->clone(copy.tree_root, nullptr);
+    this->tree_size = copy.tree_size;
+}
+
+template <typename T, typename Pool> rb_tree<T,Pool>::rb_tree(rb_tree&& other) : rb_tree() {
+    this->swap(other);
+}
+
+template <typename T, typename Pool> rb_tree<T,Pool>::~rb_tree() {
+    this->clear();
+}
+
+template <typename T, typename Pool> rb_tree<T,Pool>& rb_tree<T,Pool>::operator=(rb_tree copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T, typename Pool> template <typename It>
+rb_tree<T,Pool> rb_tree<T,Pool>::from_sorted(It first, It last) {
+    rb_tree tree;
+
+    tree.assign_sorted(first, last);
+
+    return tree;
+}
+
+template <typename T, typename Pool> template <typename Range>
+rb_tree<T,Pool> rb_tree<T,Pool>::from_sorted(const Range& range) {
+    return from_sorted(range.begin(), range.end());
+}
+
+// Replaces the contents with the values of [first, last), which must be
+// sorted, in linear time and without rebalancing. The range is walked
+// twice, once to count it, so it takes forward iterators.
+template <typename T, typename Pool> template <typename It>
+void rb_tree<T,Pool>::assign_sorted(It first, It last, bool unique) {
+    this->clear();
+
+    int64_t n = 0;
+
+    for (It it = first; it != last; n++) {
+        It start = it++;
+
+        if (unique) {
+            while (it != last && *it == *start) ++it;
+        }
+    }
+
+    // The depth of the last level of a perfectly balanced tree: floor(log2(n)).
+    int64_t red_depth = 0;
+
+    while ((static_cast<int64_t>(2) << red_depth) <= n) ++red_depth;
+
+    this->tree_root = this->build(first, last, n, 0, red_depth, nullptr, unique);
+    this->tree_size = n;
+}
 
-    node->color(this->tree_root == nullptr ? BLACK : RED);
+// Standard BST insertion, then recoloring.
+template <typename T, typename Pool> void rb_tree<T,Pool>::link(rb_node<T>* node) {
+    ++this->tree_size;
 
     if (this->tree_root == nullptr) {
+        node->color(BLACK);
         this->tree_root = node;
         return;
     }
 
-    // Standard BST insertion
     rb_node<T>* parent = this->tree_root;
 
     while (true) {
-        bool direction = (parent->value() <= node->value());
-
+        int D = (parent->value_ref() <= node->value_ref());
 
-        if ((direction && parent->right() == nullptr) ||
-            (!direction && parent->left() == nullptr)) {
-
-            (direction ? parent->right(node) : parent->left(node));
+        if (parent->child(D) == nullptr) {
+            parent->child(node, D);
             break;
         }
 
-        parent = (direction ? parent->right() : parent->left());
+        parent = parent->child(D);
     }
 
     node->parent(parent);
+    node->color(RED);
 
-    this->maintain_properties_insertion(node);
-
-    ++this->tree_size;
+    maintain_properties_insertion(node, this->tree_root);
 }
 
-template <typename T> void rb_tree<T>::insert(T value) {
-    this->insert(new rb_node<T>(value));
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::insert(T value) {
+    rb_node<T>* node = this->pool.acquire(std::move(value));
+
+    this->link(node);
+
+    return node;
 }
 
-template <typename T> void rb_tree<T>::remove(rb_node<T>* node) {
+// node must belong to this tree. Its successor is moved into its place
+// rather than swapping values, so pointers to other nodes stay valid.
+template <typename T, typename Pool> void rb_tree<T,Pool>::remove(rb_node<T>* node) {
     if (node == nullptr)
         return;
 
-    rb_node<T> *moved_node = nullptr;
-    rb_color_t deleted_color;
+    rb_node<T> *moved_node, *moved_parent;
+    rb_color_t deleted_color = node->color();
+
+    if (node->left() == nullptr || node->right() == nullptr) {
+        moved_node = (node->left() != nullptr ? node->left() : node->right());
+        moved_parent = node->parent();
 
-    if (node->children() <= 1) {
-        deleted_color = node_color(node);
-        moved_node = this->non_double_removal(node);
+        this->transplant(node, moved_node);
     } else {
-        rb_node<T>* successor = inorder_successor(node);
-        swap(successor, node);
+        rb_node<T>* successor = minimum(node->right());
 
-        deleted_color = node_color(successor);
-        moved_node = this->non_double_removal(successor);
-    }
+        deleted_color = successor->color();
+        moved_node = successor->right();
+        moved_parent = successor;
+
+        if (successor->parent() != node) {
+            moved_parent = successor->parent();
+
+            this->transplant(successor, successor->right());
+            successor->right(node->right());
+            successor->right()->parent(successor);
+        }
 
-    if (deleted_color == BLACK) {
-        this->maintain_properties_deletion(moved_node);
+        this->transplant(node, successor);
+        successor->left(node->left());
+        successor->left()->parent(successor);
+        successor->color(node->color());
     }
 
+    if (deleted_color == BLACK)
+        this->maintain_properties_deletion(moved_node, moved_parent);
+
+    this->pool.release(node);
     --this->tree_size;
 }
 
-template <typename T> void rb_tree<T>::remove(T key) {
+template <typename T, typename Pool> void rb_tree<T,Pool>::remove(T key) {
     rb_node<T>* node = this->search(key);
 
     if (node == nullptr)
@@ -256,108 +529,680 @@ template <typename T> void rb_tree<T>::remove(T key) {
     this->remove(node);
 }
 
-template <typename T> rb_node<T>* rb_tree<T>::search(T key) const {
-    rb_node<T>* current = this->tree_root;
+// Values that compare equal in the ordering without being ==, such as
+// pairs with the same key, can end up on either side of each other after
+// rotations, so the whole run of them is checked from its leftmost node.
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::search(T key) const {
+    rb_node<T>* bound = this->find(key);
+
+    while (bound != nullptr && !(key < bound->value_ref())) {
+        if (bound->value_ref() == key) 
+            return bound;
+
+        bound = inorder_successor(bound);
+    }
+
+    return nullptr;
+}
 
-    while (current != nullptr && current->value() != key) {
-        bool R = (current->value() <= key);
+// The first node whose value is not less than value, or null.
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::lower(const T& value) const {
+    rb_node<T> *current = this->tree_root,
+               *bound = nullptr;
 
-        current = (R ? current->right() : current->left());
+    while (current != nullptr) {
+        if (current->value_ref() < value) {
+            current = current->right();
+        } else {
+            bound = current;
+            current = current->left();
+        }
     }
 
-    return current;
+    return bound;
 }
 
-template <typename T> rb_node<T>* rb_tree<T>::root() const {
+// The first node whose value is greater than value, or null.
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::upper(const T& value) const {
+    rb_node<T> *current = this->tree_root,
+               *bound = nullptr;
+
+    while (current != nullptr) {
+        if (value < current->value_ref()) {
+            bound = current;
+            current = current->left();
+        } else {
+            current = current->right();
+        }
+    }
+
+    return bound;
+}
+
+// The first node whose value is neither less nor greater than key.
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::find(T key) const {
+    rb_node<T>* bound = this->lower(key);
+
+    return (bound == nullptr || key < bound->value_ref() ? nullptr : bound);
+}
+
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::iterator rb_tree<T,Pool>::lower_bound(T value) const {
+    return iterator(this->lower(value), &this->tree_root);
+}
+
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::iterator rb_tree<T,Pool>::upper_bound(T value) const {
+    return iterator(this->upper(value), &this->tree_root);
+}
+
+// The run of values neither less nor greater than value.
+template <typename T, typename Pool>
+std::pair<typename rb_tree<T,Pool>::iterator, typename rb_tree<T,Pool>::iterator>
+rb_tree<T,Pool>::equal_range(T value) const {
+    return std::make_pair(this->lower_bound(value), this->upper_bound(value));
+}
+
+// The last node whose value is not greater than value, or null.
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::floor(T value) const {
+    rb_node<T>* bound = this->upper(value);
+
+    if (bound == nullptr)
+        return (this->tree_root == nullptr ? nullptr : maximum(this->tree_root));
+
+    return inorder_predecessor(bound);
+}
+
+// The first node whose value is not less than value, or null.
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::ceiling(T value) const {
+    return this->lower(value);
+}
+
+// Calls fn on every value in [lo, hi), in order. The scan starts from one
+// descent and follows successors, so it takes O(log n + k) for k values
+// and builds nothing.
+template <typename T, typename Pool> template <typename F>
+void rb_tree<T,Pool>::for_each_in_range(T lo, T hi, F fn) const {
+    for (rb_node<T>* node = this->lower(lo); node != nullptr && node->value_ref() < hi;
+         node = inorder_successor(node)) {
+        fn(node->value_ref());
+    }
+}
+
+template <typename T, typename Pool> rb_node<T>* rb_tree<T,Pool>::root() const {
     return this->tree_root;
 }
 
-template <typename T> int64_t rb_tree<T>::size() const {
-    return (this->tree_size + 1);
+template <typename T, typename Pool> int64_t rb_tree<T,Pool>::size() const {
+    return this->tree_size;
+}
+
+// Only values that need destroying are visited; the slabs themselves
+// are released in one sweep.
+template <typename T, typename Pool> void rb_tree<T,Pool>::clear() {
+    if (!std::is_trivially_destructible<T>::value && this->tree_root != nullptr) {
+        stack<rb_node<T>*> pending;
+
+        pending.push(this->tree_root);
+
+        while (!pending.is_empty()) {
+            rb_node<T>* node = pending.pop();
+
+            if (node->left() != nullptr) pending.push(node->left());
+            if (node->right() != nullptr) pending.push(node->right());
+
+            this->pool.release(node);
+        }
+    }
+
+    this->pool.release_all();
+    this->tree_root = nullptr;
+    this->tree_size = 0;
+}
+
+template <typename T, typename Pool> void rb_tree<T,Pool>::swap(rb_tree& other) {
+    std::swap(this->tree_size, other.tree_size);
+    std::swap(this->tree_root, other.tree_root);
+    this->pool.swap(other.pool);
+}
+
+template <typename T, typename Pool> void rb_tree<T,Pool>::dropped::push(rb_node<T>* root) {
+    if (root == nullptr)
+        return;
+
+    root->parent(nullptr);
+
+    if (this->tail == nullptr) this->head = root;
+    else this->tail->parent(root);
+
+    this->tail = root;
+}
+
+template <typename T, typename Pool> void rb_tree<T,Pool>::dropped::append(dropped& other) {
+    if (other.head == nullptr)
+        return;
+
+    if (this->tail == nullptr) this->head = other.head;
+    else this->tail->parent(other.head);
+
+    this->tail = other.tail;
+    other.head = other.tail = nullptr;
+}
+
+template <typename T, typename Pool> int64_t rb_tree<T,Pool>::black_height(rb_node<T>* node) {
+    int64_t height = 0;
+
+    for (; node != nullptr; node = node->left()) height += (node->color() == BLACK);
+
+    return height;
+}
+
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::detach(rb_node<T>* node, int64_t height) {
+    if (node != nullptr)
+        node->parent(nullptr);
+
+    return subtree{ node, height };
+}
+
+// Joins left, node and right, whose values must be in that order, into
+// one subtree. The shorter side is hung from the spine of the taller one
+// at the first black node of equal black height, under node colored red,
+// and any red-red violation is fixed as after an insert. That costs
+// O(difference of the black heights + 1).
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::join(subtree left, rb_node<T>* node, subtree right) {
+    // Red roots are blackened first, so both sides have black roots.
+    if (node_color(left.root) == RED) { left.root->color(BLACK); ++left.height; }
+    if (node_color(right.root) == RED) { right.root->color(BLACK); ++right.height; }
+
+    if (left.height == right.height) {
+        node->left(left.root);
+        node->right(right.root);
+        node->parent(nullptr);
+        node->color(BLACK);
+
+        if (left.root != nullptr) left.root->parent(node);
+        if (right.root != nullptr) right.root->parent(node);
+
+        return subtree{ node, left.height + 1 };
+    }
+
+    // D is the side of the taller tree's spine to walk down.
+    int D = (left.height > right.height);
+    subtree tall = (D ? left : right),
+            shorter = (D ? right : left);
+
+    rb_node<T> *current = tall.root,
+               *parent = nullptr;
+    int64_t height = tall.height;
+
+    while (node_color(current) == RED || height != shorter.height) {
+        height -= (node_color(current) == BLACK);
+
+        parent = current;
+        current = current->child(D);
+    }
+
+    node->child(current, 1-D);
+    node->child(shorter.root, D);
+
+    if (current != nullptr) current->parent(node);
+    if (shorter.root != nullptr) shorter.root->parent(node);
+
+    node->color(RED);
+    node->parent(parent);
+    parent->child(node, D);
+
+    rb_node<T>* root = tall.root;
+    bool grew = maintain_properties_insertion(node, root);
+
+    return subtree{ root, tall.height + grew };
+}
+
+// Joins two subtrees without a middle node by taking out the maximum of
+// left to serve as one.
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::join(subtree left, subtree right) {
+    if (left.root == nullptr) return right;
+    if (right.root == nullptr) return left;
+
+    subtree rest, empty;
+    rb_node<T>* last;
+
+    split(left, maximum(left.root)->value_ref(), rest, empty, last);
+
+    return join(rest, last, right);
+}
+
+// Splits tree into the values less than key and the values greater than
+// it, in O(log n) joins whose costs add up to O(log n). A node equivalent
+// to key comes out on its own as found, or found is null.
+template <typename T, typename Pool>
+void rb_tree<T,Pool>::split(subtree tree, const T& key, subtree& left, subtree& right, rb_node<T>*& found) {
+    rb_node<T>* node = tree.root;
+
+    if (node == nullptr) {
+        left = right = subtree{ nullptr, 0 };
+        found = nullptr;
+        return;
+    }
+
+    int64_t height = tree.height - (node->color() == BLACK);
+    subtree l = detach(node->left(), height),
+            r = detach(node->right(), height);
+
+    if (key < node->value_ref()) {
+        split(l, key, left, right, found);
+        right = join(right, node, r);
+    } else if (node->value_ref() < key) {
+        split(r, key, left, right, found);
+        left = join(l, node, left);
+    } else {
+        left = l;
+        right = r;
+
+        node->isolate();
+        found = node;
+    }
+}
+
+template <typename T, typename Pool> template <typename Fork, typename L, typename R>
+void rb_tree<T,Pool>::both(Fork& fork, int64_t depth, L left, R right) {
+    if (depth > 0) {
+        fork(left, right);
+    } else {
+        left();
+        right();
+    }
+}
+
+template <typename T, typename Pool> template <typename Fork>
+typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::unite(subtree a, subtree b, dropped& out,
+                                                       Fork& fork, int64_t depth) {
+    if (a.root == nullptr) return b;
+    if (b.root == nullptr) return a;
+
+    rb_node<T>* node = a.root;
+    int64_t height = a.height - (node->color() == BLACK);
+    subtree al = detach(node->left(), height),
+            ar = detach(node->right(), height),
+            bl, br, l, r;
+    rb_node<T>* found;
+
+    split(b, node->value_ref(), bl, br, found);
+    out.push(found);
+
+    dropped right_out;
+
+    both(fork, depth, [&]() { l = unite(al, bl, out, fork, depth - 1); },
+                      [&]() { r = unite(ar, br, right_out, fork, depth - 1); });
+
+    out.append(right_out);
+
+    return join(l, node, r);
+}
+
+// b is only read; the nodes kept are a's.
+template <typename T, typename Pool> template <typename Fork>
+typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::intersect(subtree a, const rb_node<T>* b, dropped& out,
+                                                           Fork& fork, int64_t depth) {
+    if (a.root == nullptr)
+        return a;
+
+    if (b == nullptr) {
+        out.push(a.root);
+        return subtree{ nullptr, 0 };
+    }
+
+    subtree al, ar, l, r;
+    rb_node<T>* found;
+
+    split(a, b->value_ref(), al, ar, found);
+
+    dropped right_out;
+
+    both(fork, depth, [&]() { l = intersect(al, b->left(), out, fork, depth - 1); },
+                      [&]() { r = intersect(ar, b->right(), right_out, fork, depth - 1); });
+
+    out.append(right_out);
+
+    return (found != nullptr ? join(l, found, r) : join(l, r));
+}
+
+// b is only read.
+template <typename T, typename Pool> template <typename Fork>
+typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::subtract(subtree a, const rb_node<T>* b, dropped& out,
+                                                          Fork& fork, int64_t depth) {
+    if (a.root == nullptr || b == nullptr)
+        return a;
+
+    subtree al, ar, l, r;
+    rb_node<T>* found;
+
+    split(a, b->value_ref(), al, ar, found);
+    out.push(found);
+
+    dropped right_out;
+
+    both(fork, depth, [&]() { l = subtract(al, b->left(), out, fork, depth - 1); },
+                      [&]() { r = subtract(ar, b->right(), right_out, fork, depth - 1); });
+
+    out.append(right_out);
+
+    return join(l, r);
+}
+
+template <typename T, typename Pool> template <typename Fork>
+typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::symmetric_subtract(subtree a, subtree b, dropped& out,
+                                                                    Fork& fork, int64_t depth) {
+    if (a.root == nullptr) return b;
+    if (b.root == nullptr) return a;
+
+    rb_node<T>* node = a.root;
+    int64_t height = a.height - (node->color() == BLACK);
+    subtree al = detach(node->left(), height),
+            ar = detach(node->right(), height),
+            bl, br, l, r;
+    rb_node<T>* found;
+
+    split(b, node->value_ref(), bl, br, found);
+
+    dropped right_out;
+
+    both(fork, depth, [&]() { l = symmetric_subtract(al, bl, out, fork, depth - 1); },
+                      [&]() { r = symmetric_subtract(ar, br, right_out, fork, depth - 1); });
+
+    out.append(right_out);
+
+    if (found == nullptr)
+        return join(l, node, r);
+
+    node->isolate();
+    out.push(node);
+    out.push(found);
+
+    return join(l, r);
 }
 
-template <typename T> void rb_tree<T>::clear() {
+// Hands the whole tree over as a subtree, leaving this one empty.
+template <typename T, typename Pool> typename rb_tree<T,Pool>::subtree rb_tree<T,Pool>::take_root() {
+    subtree tree{ this->tree_root, black_height(this->tree_root) };
+
     this->tree_root = nullptr;
+    this->tree_size = 0;
+
+    return tree;
+}
+
+// Installs the result of the set algebra, which held size values before
+// the dropped subtrees are released.
+template <typename T, typename Pool> void rb_tree<T,Pool>::adopt(subtree tree, int64_t size, dropped& out) {
+    stack<rb_node<T>*> pending;
+
+    for (rb_node<T>* root = out.head; root != nullptr; ) {
+        rb_node<T>* next = root->parent();
+
+        pending.push(root);
+
+        while (!pending.is_empty()) {
+            rb_node<T>* node = pending.pop();
+
+            if (node->left() != nullptr) pending.push(node->left());
+            if (node->right() != nullptr) pending.push(node->right());
+
+            this->pool.release(node);
+            --size;
+        }
+
+        root = next;
+    }
+
+    if (tree.root != nullptr) {
+        tree.root->parent(nullptr);
+        tree.root->color(BLACK);
+    }
+
+    this->tree_root = tree.root;
+    this->tree_size = size;
+}
+
+// Adds other's values; other's nodes and pool move into this tree.
+template <typename T, typename Pool> template <typename Fork>
+void rb_tree<T,Pool>::unite(rb_tree&& other, Fork fork, int64_t depth) {
+    if (&other == this)
+        return;
+
+    int64_t size = this->tree_size + other.tree_size;
+    dropped out;
+
+    this->pool.absorb(other.pool);
+
+    subtree a = this->take_root(),
+            b = other.take_root();
+
+    this->adopt(unite(a, b, out, fork, depth), size, out);
+}
+
+// Keeps only the values also in other.
+template <typename T, typename Pool> template <typename Fork>
+void rb_tree<T,Pool>::intersect(const rb_tree& other, Fork fork, int64_t depth) {
+    if (&other == this)
+        return;
+
+    int64_t size = this->tree_size;
+    dropped out;
+    subtree a = this->take_root();
+
+    this->adopt(intersect(a, other.tree_root, out, fork, depth), size, out);
+}
+
+// Removes the values that are in other.
+template <typename T, typename Pool> template <typename Fork>
+void rb_tree<T,Pool>::subtract(const rb_tree& other, Fork fork, int64_t depth) {
+    if (&other == this) {
+        this->clear();
+        return;
+    }
+
+    int64_t size = this->tree_size;
+    dropped out;
+    subtree a = this->take_root();
+
+    this->adopt(subtract(a, other.tree_root, out, fork, depth), size, out);
+}
+
+// Keeps the values in exactly one of the two trees; other's nodes and
+// pool move into this tree.
+template <typename T, typename Pool> template <typename Fork>
+void rb_tree<T,Pool>::symmetric_subtract(rb_tree&& other, Fork fork, int64_t depth) {
+    if (&other == this) {
+        this->clear();
+        return;
+    }
+
+    int64_t size = this->tree_size + other.tree_size;
+    dropped out;
+
+    this->pool.absorb(other.pool);
+
+    subtree a = this->take_root(),
+            b = other.take_root();
+
+    this->adopt(symmetric_subtract(a, b, out, fork, depth), size, out);
+}
+
+template <typename T, typename Pool> typename rb_tree<T,Pool>::iterator rb_tree<T,Pool>::begin() const {
+    return iterator(this->tree_root == nullptr ? nullptr : minimum(this->tree_root), &this->tree_root);
+}
+
+template <typename T, typename Pool> typename rb_tree<T,Pool>::iterator rb_tree<T,Pool>::end() const {
+    return iterator(nullptr, &this->tree_root);
+}
+
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::const_iterator rb_tree<T,Pool>::cbegin() const { return this->begin(); }
+
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::const_iterator rb_tree<T,Pool>::cend() const { return this->end(); }
+
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::reverse_iterator rb_tree<T,Pool>::rbegin() const {
+    return reverse_iterator(this->end());
+}
+
+template <typename T, typename Pool>
+typename rb_tree<T,Pool>::reverse_iterator rb_tree<T,Pool>::rend() const {
+    return reverse_iterator(this->begin());
+}
+
+// The visitors call fn on every node of a subtree, or on every value of
+// a tree, in the given order, without building anything. They walk the
+// subtree with an explicit stack instead of recursing; the path to the
+// current node is all that is kept, so the stack's inline buffer covers
+// any balanced tree and the walk does not allocate.
+template <typename T, typename F> inline void visit_inorder(rb_node<T>* node, F fn) {
+    stack<rb_node<T>*> path;
+
+    while (node != nullptr || !path.is_empty()) {
+        while (node != nullptr) {
+            path.push(node);
+            node = node->left();
+        }
+
+        node = path.pop();
+        fn(node);
+        node = node->right();
+    }
+}
+
+template <typename T, typename F> inline void visit_preorder(rb_node<T>* node, F fn) {
+    stack<rb_node<T>*> path;
+
+    if (node != nullptr)
+        path.push(node);
+
+    while (!path.is_empty()) {
+        node = path.pop();
+        fn(node);
+
+        // Pushed right first so that the left subtree comes out first.
+        if (node->right() != nullptr) path.push(node->right());
+        if (node->left() != nullptr) path.push(node->left());
+    }
 }
 
-template <typename T> std::ostream& operator<<(std::ostream& out, const rb_tree<T> tree) {
+// A node is visited once its right subtree is done, which is when that
+// subtree's root was the last node visited.
+template <typename T, typename F> inline void visit_postorder(rb_node<T>* node, F fn) {
+    stack<rb_node<T>*> path;
+    rb_node<T>* last = nullptr;
+
+    while (node != nullptr || !path.is_empty()) {
+        if (node != nullptr) {
+            path.push(node);
+            node = node->left();
+            continue;
+        }
+
+        rb_node<T>* top = path.top();
+
+        if (top->right() != nullptr && top->right() != last) {
+            node = top->right();
+        } else {
+            fn(top);
+            last = path.pop();
+        }
+    }
+}
+
+// Left to right within a level. The queue holds up to one level of the
+// tree, so unlike the other orders it allocates, once per call.
+template <typename T, typename F> inline void visit_level_order(rb_node<T>* node, F fn) {
     deque<rb_node<T>*> q;
 
-    if (tree.root() != nullptr) q.push_back(tree.root());
+    if (node != nullptr)
+        q.push_back(node);
 
     while (!q.is_empty()) {
-        rb_node<T>* node = q.pop_front();
-
-        out << *node;
+        node = q.pop_front();
+        fn(node);
 
         if (node->left() != nullptr) q.push_back(node->left());
         if (node->right() != nullptr) q.push_back(node->right());
     }
+}
+
+template <typename T, typename Pool, typename F> inline void visit_inorder(const rb_tree<T,Pool>& tree, F fn) {
+    visit_inorder(tree.root(), [&fn](rb_node<T>* node) { fn(node->value_ref()); });
+}
+
+template <typename T, typename Pool, typename F> inline void visit_preorder(const rb_tree<T,Pool>& tree, F fn) {
+    visit_preorder(tree.root(), [&fn](rb_node<T>* node) { fn(node->value_ref()); });
+}
+
+template <typename T, typename Pool, typename F> inline void visit_postorder(const rb_tree<T,Pool>& tree, F fn) {
+    visit_postorder(tree.root(), [&fn](rb_node<T>* node) { fn(node->value_ref()); });
+}
+
+template <typename T, typename Pool, typename F>
+inline void visit_level_order(const rb_tree<T,Pool>& tree, F fn) {
+    visit_level_order(tree.root(), [&fn](rb_node<T>* node) { fn(node->value_ref()); });
+}
+
+template <typename T, typename Pool> std::ostream& operator<<(std::ostream& out, const rb_tree<T,Pool>& tree) {
+    visit_level_order(tree.root(), [&out](rb_node<T>* node) { out << *node; });
 
     return out;
 }
 
-template <typename T> std::ostream& operator<<(std::ostream& out, rb_tree<T>* tree) {
+template <typename T, typename Pool> std::ostream& operator<<(std::ostream& out, const rb_tree<T,Pool>* tree) {
     return out << *tree;
 }
 
+// The list-building traversals, for callers that want the values kept.
 template <typename T> inline void inorder_traversal(rb_node<T>* node, 
                                                     list<T>* &list = nullptr)  {
-    if (node == nullptr)
-        return;
-
-    inorder_traversal(node->left(), list);
-
-    if (list != nullptr)
-        list->push_back(node->value());
-
-    inorder_traversal(node->right(), list);
+    visit_inorder(node, [list](rb_node<T>* n) { if (list != nullptr) list->push_back(n->value()); });
 }
 
 template <typename T> inline void preorder_traversal(rb_node<T>* node,
                                                      list<T>* &list = nullptr) {
-    if (node == nullptr)
-        return;
-
-    if (list != nullptr) 
-        list->push_back(node->value());
-
-    preorder_traversal(node->left(), list);
-    preorder_traversal(node->right(), list);
+    visit_preorder(node, [list](rb_node<T>* n) { if (list != nullptr) list->push_back(n->value()); });
 }
 
 template <typename T> inline void postorder_traversal(rb_node<T>* node,
                                                       list<T>* &list = nullptr) {
-    if (node == nullptr)
-        return;
+    visit_postorder(node, [list](rb_node<T>* n) { if (list != nullptr) list->push_back(n->value()); });
+}
 
-    postorder_traversal(node->left(), list);
-    postorder_traversal(node->right(), list);         
+template <typename T, typename Pool> inline list<T> inorder_traversal(const rb_tree<T,Pool>& tree) {
+    list<T> traversal;
 
-    if (list != nullptr)
-        list->push_back(node->value());
-}
+    visit_inorder(tree, [&traversal](const T& value) { traversal.push_back(value); });
 
-template <typename T> inline list<T> inorder_traversal(const rb_tree<T>& tree) {
-    list<T>* traversal= new list<T>();
-    inorder_traversal(tree.root(), traversal);
-    return *traversal;
+    return traversal;
 }
 
-template <typename T> inline list<T> preorder_traversal(const rb_tree<T>& tree) {
-    list<T>* traversal = new list<T>();
-    preorder_traversal(tree.root(), traversal);
-    return *traversal;
+template <typename T, typename Pool> inline list<T> preorder_traversal(const rb_tree<T,Pool>& tree) {
+    list<T> traversal;
+
+    visit_preorder(tree, [&traversal](const T& value) { traversal.push_back(value); });
+
+    return traversal;
 }
 
-template <typename T> inline list<T> postorder_traversal(const rb_tree<T>& tree) {
-    list<T>* traversal = new list<T>();
-    postorder_traversal(tree.root(), traversal);
-    return *traversal;
+template <typename T, typename Pool> inline list<T> postorder_traversal(const rb_tree<T,Pool>& tree) {
+    list<T> traversal;
+
+    visit_postorder(tree, [&traversal](const T& value) { traversal.push_back(value); });
+
+    return traversal;
 }
 
-template <typename T> inline list<T> level_order_traversal(const rb_tree<T>& tree) {
-    list<T>* traversal = new list<T>();
+// Right to left within a level, as it always has been.
+template <typename T, typename Pool> inline list<T> level_order_traversal(const rb_tree<T,Pool>& tree) {
+    list<T> traversal;
 
     deque<rb_node<T>*> q;
 
@@ -367,7 +1212,7 @@ template <typename T> inline list<T> level_order_traversal(const rb_tree<T>& tre
     while (!q.is_empty()) {
         rb_node<T>* node = q.pop_front();
 
-        traversal->push_back(node->value());
+        traversal.push_back(node->value());
 
         if (node->right() != nullptr) 
             q.push_back(node->right());
@@ -375,7 +1220,86 @@ template <typename T> inline list<T> level_order_traversal(const rb_tree<T>& tre
             q.push_back(node->left());
     }
 
-    return *traversal;
+    return traversal;
+}
+
+#if defined(__cpp_impl_coroutine)
+// Generators over the values of a tree, for pulling them one at a time:
+//
+//     for (const T& value : inorder(tree)) ...
+//
+// The tree must not change while a generator is in use. The coroutine
+// frame, with the path stack inline in it, is the one allocation.
+template <typename T, typename Pool> generator<T> inorder(const rb_tree<T,Pool>& tree) {
+    stack<rb_node<T>*> path;
+    rb_node<T>* node = tree.root();
+
+    while (node != nullptr || !path.is_empty()) {
+        while (node != nullptr) {
+            path.push(node);
+            node = node->left();
+        }
+
+        node = path.pop();
+        co_yield node->value_ref();
+        node = node->right();
+    }
+}
+
+template <typename T, typename Pool> generator<T> preorder(const rb_tree<T,Pool>& tree) {
+    stack<rb_node<T>*> path;
+
+    if (tree.root() != nullptr)
+        path.push(tree.root());
+
+    while (!path.is_empty()) {
+        rb_node<T>* node = path.pop();
+
+        if (node->right() != nullptr) path.push(node->right());
+        if (node->left() != nullptr) path.push(node->left());
+
+        co_yield node->value_ref();
+    }
 }
 
+template <typename T, typename Pool> generator<T> postorder(const rb_tree<T,Pool>& tree) {
+    stack<rb_node<T>*> path;
+    rb_node<T> *node = tree.root(),
+               *last = nullptr;
+
+    while (node != nullptr || !path.is_empty()) {
+        if (node != nullptr) {
+            path.push(node);
+            node = node->left();
+            continue;
+        }
+
+        rb_node<T>* top = path.top();
+
+        if (top->right() != nullptr && top->right() != last) {
+            node = top->right();
+        } else {
+            last = path.pop();
+            co_yield last->value_ref();
+        }
+    }
+}
+
+template <typename T, typename Pool> generator<T> level_order(const rb_tree<T,Pool>& tree) {
+    deque<rb_node<T>*> q;
+
+    if (tree.root() != nullptr)
+        q.push_back(tree.root());
+
+    while (!q.is_empty()) {
+        rb_node<T>* node = q.pop_front();
+
+        if (node->left() != nullptr) q.push_back(node->left());
+        if (node->right() != nullptr) q.push_back(node->right());
+
+        co_yield node->value_ref();
+    }
+}
+#endif
+
 #endif
@@ -5,109 +5,105 @@
 #include "pair.hpp"
 #include "rb_tree.hpp"
 
-template <typename T> class set : public rb_tree<T> {
+// Ordered set over a tree backend: rb_tree by default, or b_tree, or
+// anything else with the same insert, remove, search, size, clear,
+// assign_sorted, unite, intersect, subtract, symmetric_subtract and
+// iteration. The set operations below go through the last four, which
+// rb_tree does by split and join and b_tree by a linear merge.
+template <typename T, typename Tree = rb_tree<T>> class set : public Tree {
     public:
-        set(rb_node<T>* root = nullptr);
-
-        set(set<T>& copy);
+        set();
+        set(const set& copy);
+        set(set&& other);
 
         ~set() {}
 
-        set<T>& operator=(set<T> copy);
-        set<T> operator+(set<T>& w);
-        set<T> operator-(set<T>& w);
-        set<T> operator-(T value);
-        set<T> operator+(T value);
+        set& operator=(set copy);
+
+        template <typename It> static set from_sorted(It first, It last);
+        template <typename Range> static set from_sorted(const Range& range);
 
-        template <typename K> set<pair<T,K>> operator*(set<K>& w);
+        set operator+(const set& w) const;
+        set operator-(const set& w) const;
+        set operator-(T value) const;
+        set operator+(T value) const;
+
+        template <typename K, typename U> set<pair<T,K>> operator*(const set<K,U>& w) const;
 
         void insert(T value);
 };
 
-template <typename T> set<T>::set(rb_node<T>* root) : rb_tree<T>(root) {}
+template <typename T, typename Tree> set<T,Tree>::set() {}
 
-template <typename T> set<T>::set(set<T>& copy) {
-    list<T> order = level_order_traversal(copy);
+template <typename T, typename Tree> set<T,Tree>::set(const set& copy) : Tree(copy) {}
 
-    while (!order.is_empty()) {
-        this->insert(order.pop_front());
-    }
-}
-
-template <typename T> void set<T>::insert(T value) {
-    rb_node<T> *s = this->search(value),
-               *n = new rb_node<T>(value);
+template <typename T, typename Tree> set<T,Tree>::set(set&& other) : Tree(std::move(other)) {}
 
-    if (s == nullptr) 
-        rb_tree<T>::insert(n);
-}
+// Builds the set in linear time from sorted values; repeated values are
+// kept once.
+template <typename T, typename Tree> template <typename It>
+set<T,Tree> set<T,Tree>::from_sorted(It first, It last) {
+    set s;
 
-template <typename T> set<T>& set<T>::operator=(set<T> copy) {
-    if (this == &copy) 
-        return *this;
+    s.assign_sorted(first, last, true);
 
-    this->clear();
+    return s;
+}
 
-    list<T> order = level_order_traversal(copy);
+template <typename T, typename Tree> template <typename Range>
+set<T,Tree> set<T,Tree>::from_sorted(const Range& range) {
+    return from_sorted(range.begin(), range.end());
+}
 
-    while (!order.is_empty()) {
-        this->insert(order.pop_front());
-    }
+// A node is only taken from the pool once the value is known to be new.
+template <typename T, typename Tree> void set<T,Tree>::insert(T value) {
+    if (this->search(value) == nullptr) 
+        Tree::insert(std::move(value));
+}
 
+// copy is built by the copy or move constructor, so assigning from a
+// temporary only swaps the trees.
+template <typename T, typename Tree> set<T,Tree>& set<T,Tree>::operator=(set copy) {
+    this->swap(copy);
     return *this;
 }
 
-template <typename T> set<T> set<T>::operator+(set<T>& w) { 
-    set<T> u = *this;
-
-    list<T> order = level_order_traversal(w);
+// w is copied so that its nodes can be joined into the union.
+template <typename T, typename Tree> set<T,Tree> set<T,Tree>::operator+(const set& w) const { 
+    set u = *this;
 
-    while (!order.is_empty()) {
-        u.insert(order.pop_front());
-    }
+    u.unite(set(w));
 
-    return order;
+    return u;
 }
 
-template <typename T> set<T> set<T>::operator-(set<T>& w) {
-    set<T> d;
+template <typename T, typename Tree> set<T,Tree> set<T,Tree>::operator-(const set& w) const {
+    set d = *this;
 
-    list<T> first_order = inorder_traversal(*this),
-            second_order = inorder_traversal(w);
-
-    if (first_order.size() == 0 || second_order.size() == 0)
-        return d;
-
-    for (int64_t k = 0; k < first_order.size(); k++) {
-        if (binary_search(second_order, first_order[k]) == -1) 
-            d.insert(first_order[k]);
-    }
+    d.subtract(w);
 
     return d;
 }
 
-template <typename T> set<T> set<T>::operator-(T value) {
-    set<T> d = *this;
+template <typename T, typename Tree> set<T,Tree> set<T,Tree>::operator-(T value) const {
+    set d = *this;
     d.remove(value);
     return d;
 }
 
-template <typename T> set<T> set<T>::operator+(T value) {
-    set<T> i = *this;
+template <typename T, typename Tree> set<T,Tree> set<T,Tree>::operator+(T value) const {
+    set i = *this;
     i.insert(value);
     return i;
 }
 
-template <typename T> template <typename K>
-set<pair<T,K>> set<T>::operator*(set<K>& w) { 
+template <typename T, typename Tree> template <typename K, typename U>
+set<pair<T,K>> set<T,Tree>::operator*(const set<K,U>& w) const { 
     set<pair<T,K>> p;
 
-    list<T> first_order = inorder_traversal(*this);
-    list<K> second_order = inorder_traversal(w);
-
-    for (int64_t k = 0; k < first_order.size(); k++) {
-        for (int64_t i = 0; i < second_order.size(); i++) {
-            pair<T,K> t(first_order[k], second_order[i]);
+    for (const T& first : *this) {
+        for (const K& second : w) {
+            pair<T,K> t(first, second);
             p.insert(t);
         }
     }
@@ -115,42 +111,40 @@ set<pair<T,K>> set<T>::operator*(set<K>& w) {
     return p;
 }
 
-template <typename T> set<T> set_union(set<T> w, set<T> v) { return (w + v); }
-
-template <typename T> set<T> set_difference(set<T> w, set<T> v) { return (w - v); }
-
-template <typename T, typename K> 
-set<pair<T,K>> cartesian_set_product(set<T> w, set<K> v) { return (w * v); }
+template <typename T, typename Tree>
+set<T,Tree> set_union(const set<T,Tree>& w, const set<T,Tree>& v) { return (w + v); }
 
-template <typename T> set<T> set_intersection(set<T> w, set<T> v) {
-    set<T> i;
+template <typename T, typename Tree>
+set<T,Tree> set_difference(const set<T,Tree>& w, const set<T,Tree>& v) { return (w - v); }
 
-    list<T> first_order = inorder_traversal(w), 
-            second_order = inorder_traversal(v);
+template <typename T, typename U, typename K, typename V> 
+set<pair<T,K>> cartesian_set_product(const set<T,U>& w, const set<K,V>& v) { return (w * v); }
 
-    if (first_order.size() == 0 || second_order.size() == 0) 
-        return i;
+// The smaller set is the one copied, and its values are the ones kept.
+template <typename T, typename Tree>
+set<T,Tree> set_intersection(const set<T,Tree>& w, const set<T,Tree>& v) {
+    bool smaller = (w.size() <= v.size());
+    set<T,Tree> i = (smaller ? w : v);
 
-    for (int64_t k = 0; k < first_order.size(); k++) {
-        if (binary_search(second_order, first_order[k]) != -1) {
-            i.insert(first_order[k]);
-        }
-    }
+    i.intersect(smaller ? v : w);
 
     return i;
 }
 
-template <typename T> set<T> symmetric_difference(set<T> w, set<T> v) {
-    return (w-v) + (v-w);
-}
+template <typename T, typename Tree>
+set<T,Tree> symmetric_difference(const set<T,Tree>& w, const set<T,Tree>& v) {
+    set<T,Tree> d = w;
 
-template <typename T> std::ostream& operator<<(std::ostream& out, set<T> s) {
-    list<T> order = inorder_traversal(s);
+    d.symmetric_subtract(set<T,Tree>(v));
+
+    return d;
+}
 
+template <typename T, typename Tree> std::ostream& operator<<(std::ostream& out, const set<T,Tree>& s) {
     out << '{';
 
-    for (int64_t k = 0; k < order.size(); k++) {
-        out << order[k] << (k != order.size()-1 ? "," : "");
+    for (typename set<T,Tree>::iterator it = s.begin(); it != s.end(); ++it) {
+        out << (it != s.begin() ? "," : "") << *it;
     }
 
     return out << '}';
@@ -0,0 +1,132 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+
+// Bounded lock-free queue for exactly one producer thread and one
+// consumer thread, the 1:1 case of mpmc_queue. Each side owns one index
+// and only ever publishes it with a release store, so no CAS is needed.
+// Each side also caches the last value it read of the other's index and
+// reloads it only when the queue looks full or empty, which keeps the
+// two cache lines from bouncing on every operation.
+//
+// The capacity is rounded up to a power of two.
+template <typename T> class spsc_queue {
+    private:
+        T* buffer;
+        uint64_t mask;
+
+        alignas(64) std::atomic<uint64_t> tail;
+        uint64_t head_cache;
+
+        alignas(64) std::atomic<uint64_t> head;
+        uint64_t tail_cache;
+    public:
+        spsc_queue(int64_t capacity = 1024);
+        spsc_queue(const spsc_queue& copy) = delete;
+
+        ~spsc_queue();
+
+        spsc_queue& operator=(const spsc_queue& copy) = delete;
+
+        bool try_push(T value);
+        bool try_pop(T& value);
+
+        void push(T value);
+        T pop();
+
+        int64_t capacity() const;
+        int64_t size() const;
+        bool is_empty() const;
+};
+
+template <typename T> spsc_queue<T>::spsc_queue(int64_t capacity) : tail(0), head_cache(0), head(0),
+                                                                    tail_cache(0) {
+    assert(capacity >= 1);
+
+    uint64_t slots = 2;
+
+    while (slots < static_cast<uint64_t>(capacity)) slots *= 2;
+
+    this->buffer = static_cast<T*>(::operator new(sizeof(T) * slots));
+    this->mask = slots - 1;
+}
+
+template <typename T> spsc_queue<T>::~spsc_queue() {
+    uint64_t h = this->head.load(std::memory_order_relaxed),
+             t = this->tail.load(std::memory_order_relaxed);
+
+    for (; h != t; h++) this->buffer[h & this->mask].~T();
+
+    ::operator delete(this->buffer);
+}
+
+// Producer side only.
+template <typename T> bool spsc_queue<T>::try_push(T value) {
+    uint64_t t = this->tail.load(std::memory_order_relaxed);
+
+    if (t - this->head_cache > this->mask) {
+        this->head_cache = this->head.load(std::memory_order_acquire);
+
+        if (t - this->head_cache > this->mask)
+            return false;
+    }
+
+    new (this->buffer + (t & this->mask)) T(std::move(value));
+    this->tail.store(t + 1, std::memory_order_release);
+
+    return true;
+}
+
+// Consumer side only.
+template <typename T> bool spsc_queue<T>::try_pop(T& value) {
+    uint64_t h = this->head.load(std::memory_order_relaxed);
+
+    if (h == this->tail_cache) {
+        this->tail_cache = this->tail.load(std::memory_order_acquire);
+
+        if (h == this->tail_cache)
+            return false;
+    }
+
+    T* item = this->buffer + (h & this->mask);
+
+    value = std::move(*item);
+    item->~T();
+
+    this->head.store(h + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T> void spsc_queue<T>::push(T value) {
+    while (!this->try_push(value)) std::this_thread::yield();
+}
+
+template <typename T> T spsc_queue<T>::pop() {
+    T value;
+
+    while (!this->try_pop(value)) std::this_thread::yield();
+
+    return value;
+}
+
+template <typename T> int64_t spsc_queue<T>::capacity() const { return static_cast<int64_t>(this->mask + 1); }
+
+// Approximate unless called from the producer or consumer thread.
+template <typename T> int64_t spsc_queue<T>::size() const {
+    uint64_t t = this->tail.load(std::memory_order_acquire),
+             h = this->head.load(std::memory_order_acquire);
+
+    return (t > h ? static_cast<int64_t>(t - h) : 0);
+}
+
+template <typename T> bool spsc_queue<T>::is_empty() const { return (this->size() == 0); }
+
+#endif
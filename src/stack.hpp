@@ -2,9 +2,190 @@
 #define STACK_H
 
 #pragma once
-#include "list.hpp"
+#include <assert.h>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
 
-// FILO Data Structure
-template <typename T> class stack : public list<T> {};
+// FILO Data Structure. Elements are contiguous, and the first N live in
+// a buffer inside the stack itself, so a stack that stays that shallow
+// never allocates. Past N the elements move to the heap and the buffer
+// doubles as a vector's does. The default of 64 holds the path to any
+// node of a balanced tree with up to 2^32 nodes.
+template <typename T, int64_t N = 64> class stack {
+    static_assert(N >= 1, "The inline buffer needs room for an element");
+
+    private:
+        int64_t s, cap;
+        T* buffer;
+        alignas(T) unsigned char local[N * sizeof(T)];
+
+        bool is_local() const;
+        void reallocate(int64_t new_capacity);
+        void take(stack& other);
+    public:
+        stack() : s(0), cap(N), buffer(reinterpret_cast<T*>(local)) {}
+        stack(const stack& copy);
+        stack(stack&& other);
+
+        ~stack();
+
+        stack& operator=(stack copy);
+
+        void push(T value);
+        T pop();
+
+        T& top();
+        const T& top() const;
+
+        void reserve(int64_t new_capacity);
+        void clear();
+
+        int64_t size() const;
+        int64_t capacity() const;
+        bool is_empty() const;
+
+        template <typename U, int64_t M>
+        friend std::ostream& operator<<(std::ostream& out, const stack<U,M>& s);
+};
+
+template <typename T, int64_t N> bool stack<T,N>::is_local() const {
+    return (this->buffer == reinterpret_cast<const T*>(this->local));
+}
+
+template <typename T, int64_t N> void stack<T,N>::reallocate(int64_t new_capacity) {
+    T* new_buffer = static_cast<T*>(::operator new(sizeof(T) * new_capacity));
+
+    for (int64_t k = 0; k < this->s; k++) {
+        new (new_buffer + k) T(std::move(this->buffer[k]));
+        this->buffer[k].~T();
+    }
+
+    if (!this->is_local()) ::operator delete(this->buffer);
+
+    this->buffer = new_buffer;
+    this->cap = new_capacity;
+}
+
+// Moves other's elements into this empty, local stack. A heap buffer is
+// taken over whole; inline elements have to be moved one by one.
+template <typename T, int64_t N> void stack<T,N>::take(stack& other) {
+    assert(this->s == 0 && this->is_local());
+
+    if (!other.is_local()) {
+        this->buffer = other.buffer;
+        this->cap = other.cap;
+        this->s = other.s;
+
+        other.buffer = reinterpret_cast<T*>(other.local);
+        other.cap = N;
+        other.s = 0;
+
+        return;
+    }
+
+    for (int64_t k = 0; k < other.s; k++) {
+        new (this->buffer + k) T(std::move(other.buffer[k]));
+    }
+
+    this->s = other.s;
+    other.clear();
+}
+
+template <typename T, int64_t N> stack<T,N>::stack(const stack& copy) : stack() {
+    this->reserve(copy.s);
+
+    for (int64_t k = 0; k < copy.s; k++) {
+        new (this->buffer + k) T(copy.buffer[k]);
+    }
+
+    this->s = copy.s;
+}
+
+template <typename T, int64_t N> stack<T,N>::stack(stack&& other) : stack() {
+    this->take(other);
+}
+
+template <typename T, int64_t N> stack<T,N>::~stack() {
+    this->clear();
+
+    if (!this->is_local()) ::operator delete(this->buffer);
+}
+
+template <typename T, int64_t N> stack<T,N>& stack<T,N>::operator=(stack copy) {
+    this->clear();
+
+    if (!this->is_local()) {
+        ::operator delete(this->buffer);
+
+        this->buffer = reinterpret_cast<T*>(this->local);
+        this->cap = N;
+    }
+
+    this->take(copy);
+
+    return *this;
+}
+
+template <typename T, int64_t N> void stack<T,N>::push(T value) {
+    if (this->s == this->cap) {
+        this->reallocate(this->cap * 2);
+    }
+
+    new (this->buffer + this->s++) T(std::move(value));
+}
+
+template <typename T, int64_t N> T stack<T,N>::pop() {
+    if (this->is_empty())
+        throw std::out_of_range("The stack is empty");
+
+    T value = std::move(this->buffer[--this->s]);
+    this->buffer[this->s].~T();
+
+    return value;
+}
+
+template <typename T, int64_t N> T& stack<T,N>::top() {
+    assert(this->s > 0);
+    return this->buffer[this->s-1];
+}
+
+template <typename T, int64_t N> const T& stack<T,N>::top() const {
+    assert(this->s > 0);
+    return this->buffer[this->s-1];
+}
+
+template <typename T, int64_t N> void stack<T,N>::reserve(int64_t new_capacity) {
+    if (new_capacity > this->cap)
+        this->reallocate(new_capacity);
+}
+
+// Keeps a heap buffer, if there is one, for later pushes.
+template <typename T, int64_t N> void stack<T,N>::clear() {
+    while (this->s > 0) {
+        this->buffer[--this->s].~T();
+    }
+}
+
+template <typename T, int64_t N> int64_t stack<T,N>::size() const { return this->s; }
+
+template <typename T, int64_t N> int64_t stack<T,N>::capacity() const { return this->cap; }
+
+template <typename T, int64_t N> bool stack<T,N>::is_empty() const { return (this->s == 0); }
+
+// Bottom to top.
+template <typename T, int64_t N> std::ostream& operator<<(std::ostream& out, const stack<T,N>& s) {
+    for (int64_t k = 0; k < s.s; k++) {
+        out << "[" << s.buffer[k] << "]";
+    }
+
+    return out;
+}
+
+template <typename T, int64_t N> std::ostream& operator<<(std::ostream& out, const stack<T,N>* s) {
+    return out << *s;
+}
 
 #endif
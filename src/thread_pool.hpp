@@ -0,0 +1,284 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+#include "mpmc_queue.hpp"
+#include "work_stealing_deque.hpp"
+#include "MACROS.hpp"
+
+class task_group;
+
+// Fork-join thread pool. Every worker owns a work_stealing_deque: tasks
+// spawned on a worker go to the bottom of its own deque, and an idle
+// worker steals from the top of a random other deque. Tasks spawned from
+// outside the pool go through a shared mpmc_queue. Workers with nothing
+// to do sleep until a task is queued.
+//
+// Work is forked with a task_group and joined with its sync(), which runs
+// queued tasks while it waits instead of blocking, so tasks may spawn and
+// sync recursively without tying up threads. parallel_for and
+// parallel_reduce split a range in halves that way.
+class thread_pool {
+    private:
+        struct task {
+            std::function<void()> fn;
+            std::atomic<int64_t>* pending;
+        };
+
+        struct alignas(64) worker {
+            work_stealing_deque<task*> tasks;
+            std::thread thread;
+        };
+
+        int64_t worker_count;
+        worker* workers;
+        mpmc_queue<task*> injected;
+
+        std::atomic<bool> stopping;
+        std::atomic<int64_t> queued, sleepers;
+        std::mutex sleep_lock;
+        std::condition_variable wake;
+
+        static thread_pool*& current_pool();
+        static int64_t& current_worker();
+
+        int64_t self() const;
+        void submit(task* t);
+        bool find_task(task*& t, int64_t self);
+        void run(task* t);
+        void work(int64_t index);
+
+        friend class task_group;
+    public:
+        thread_pool(int64_t threads = std::thread::hardware_concurrency());
+        thread_pool(const thread_pool& copy) = delete;
+
+        ~thread_pool();
+
+        thread_pool& operator=(const thread_pool& copy) = delete;
+
+        template <typename F>
+        void parallel_for(int64_t first, int64_t last, F fn, int64_t grain = 0);
+
+        template <typename R, typename F, typename Op>
+        R parallel_reduce(int64_t first, int64_t last, R identity, F fn, Op combine, int64_t grain = 0);
+
+        int64_t threads() const;
+};
+
+// Tasks forked together and joined by sync(). The destructor syncs, so a
+// group never outlives its tasks; tasks may therefore capture locals of
+// the spawning function by reference.
+class task_group {
+    private:
+        thread_pool& pool;
+        std::atomic<int64_t> pending;
+    public:
+        task_group(thread_pool& pool) : pool(pool), pending(0) {}
+        task_group(const task_group& copy) = delete;
+
+        ~task_group() { this->sync(); }
+
+        task_group& operator=(const task_group& copy) = delete;
+
+        template <typename F> void spawn(F fn);
+        void sync();
+};
+
+inline thread_pool*& thread_pool::current_pool() {
+    thread_local thread_pool* pool = nullptr;
+    return pool;
+}
+
+inline int64_t& thread_pool::current_worker() {
+    thread_local int64_t index = -1;
+    return index;
+}
+
+// Index of the calling worker, or -1 for a thread outside this pool.
+inline int64_t thread_pool::self() const {
+    return (current_pool() == this ? current_worker() : -1);
+}
+
+inline void thread_pool::submit(task* t) {
+    int64_t index = this->self();
+
+    ++*t->pending;
+
+    if (index >= 0) {
+        this->workers[index].tasks.push(t);
+    } else if (!this->injected.try_push(t)) {
+        // The shared queue is full; run the task here instead.
+        this->run(t);
+        return;
+    }
+
+    ++this->queued;
+
+    if (this->sleepers.load() > 0) {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->wake.notify_one();
+    }
+}
+
+// Own deque first, then the shared queue, then one pass over the other
+// workers starting at a random one.
+inline bool thread_pool::find_task(task*& t, int64_t index) {
+    if (index >= 0 && this->workers[index].tasks.pop(t)) return true;
+    if (this->injected.try_pop(t)) return true;
+
+    thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^
+                                  std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    int64_t start = static_cast<int64_t>(state % static_cast<uint64_t>(this->worker_count));
+
+    for (int64_t k = 0; k < this->worker_count; k++) {
+        int64_t victim = (start + k) % this->worker_count;
+
+        if (victim != index && this->workers[victim].tasks.steal(t)) return true;
+    }
+
+    return false;
+}
+
+inline void thread_pool::run(task* t) {
+    std::atomic<int64_t>* pending = t->pending;
+
+    t->fn();
+    delete t;
+
+    --*pending;
+}
+
+inline void thread_pool::work(int64_t index) {
+    current_pool() = this;
+    current_worker() = index;
+
+    while (true) {
+        task* t;
+
+        if (this->find_task(t, index)) {
+            --this->queued;
+            this->run(t);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(this->sleep_lock);
+
+        ++this->sleepers;
+        this->wake.wait(guard, [this]() { return this->queued.load() > 0 || this->stopping.load(); });
+        --this->sleepers;
+
+        if (this->stopping.load() && this->queued.load() == 0) return;
+    }
+}
+
+inline thread_pool::thread_pool(int64_t threads) : injected(4096), stopping(false), queued(0), sleepers(0) {
+    this->worker_count = MAX(threads, static_cast<int64_t>(1));
+    this->workers = new worker[this->worker_count];
+
+    for (int64_t k = 0; k < this->worker_count; k++) {
+        this->workers[k].thread = std::thread([this, k]() { this->work(k); });
+    }
+}
+
+inline thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->stopping.store(true);
+    }
+
+    this->wake.notify_all();
+
+    for (int64_t k = 0; k < this->worker_count; k++) this->workers[k].thread.join();
+
+    delete[] this->workers;
+}
+
+inline int64_t thread_pool::threads() const { return this->worker_count; }
+
+template <typename F> void task_group::spawn(F fn) {
+    this->pool.submit(new thread_pool::task{ std::function<void()>(std::move(fn)), &this->pending });
+}
+
+// Runs queued tasks, spawned by this group or not, until every task of
+// this group has finished.
+inline void task_group::sync() {
+    int64_t index = this->pool.self();
+
+    while (this->pending.load() > 0) {
+        thread_pool::task* t;
+
+        if (this->pool.find_task(t, index)) {
+            --this->pool.queued;
+            this->pool.run(t);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Calls fn(k) for every k in [first, last). Ranges of at most grain
+// indices run serially; grain == 0 picks about eight pieces per thread.
+template <typename F>
+void thread_pool::parallel_for(int64_t first, int64_t last, F fn, int64_t grain) {
+    if (grain <= 0)
+        grain = MAX((last - first) / (8 * this->worker_count), static_cast<int64_t>(1));
+
+    if (last - first <= grain) {
+        for (int64_t k = first; k < last; k++) fn(k);
+        return;
+    }
+
+    int64_t middle = first + (last - first) / 2;
+    task_group group(*this);
+
+    group.spawn([this, middle, last, &fn, grain]() { this->parallel_for(middle, last, fn, grain); });
+    this->parallel_for(first, middle, fn, grain);
+
+    group.sync();
+}
+
+// Folds fn(k) over [first, last) with combine, which must be associative;
+// identity is its neutral element. Pieces are combined in index order.
+template <typename R, typename F, typename Op>
+R thread_pool::parallel_reduce(int64_t first, int64_t last, R identity, F fn, Op combine, int64_t grain) {
+    if (grain <= 0)
+        grain = MAX((last - first) / (8 * this->worker_count), static_cast<int64_t>(1));
+
+    if (last - first <= grain) {
+        R result = identity;
+
+        for (int64_t k = first; k < last; k++) result = combine(result, fn(k));
+
+        return result;
+    }
+
+    int64_t middle = first + (last - first) / 2;
+    R right = identity;
+    task_group group(*this);
+
+    group.spawn([this, middle, last, &right, &identity, &fn, &combine, grain]() {
+        right = this->parallel_reduce(middle, last, identity, fn, combine, grain);
+    });
+
+    R left = this->parallel_reduce(first, middle, identity, fn, combine, grain);
+
+    group.sync();
+
+    return combine(left, right);
+}
+
+#endif
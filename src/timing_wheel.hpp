@@ -0,0 +1,222 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include "node.hpp"
+#include "pool.hpp"
+#include "MACROS.hpp"
+
+// Hierarchical timing wheel for timeouts. Level l has 256 slots of 256^l
+// ticks each, so four levels cover 2^32 ticks; a timer sits in the level
+// of the highest byte in which its expiry differs from the current tick.
+// Each time the current tick crosses a slot boundary of a higher level,
+// that slot is cascaded into the levels below, so every timer moves down
+// at most once per level before it fires.
+//
+// Timers are linked_node entries taken from a node_pool and chained into
+// per-slot lists through linked_node's next/prev links. schedule() and
+// cancel() are O(1), and advance() costs O(1) amortized per tick plus
+// the timers it fires. A handle is valid until its timer fires or is
+// cancelled; while its own callback runs it may still be cancelled,
+// which does nothing.
+template <typename V> class timing_wheel {
+    private:
+        static constexpr int64_t levels = 4;
+        static constexpr int64_t slot_bits = 8;
+        static constexpr int64_t slots = 1 << slot_bits;
+
+        struct timer {
+            uint64_t expiry;
+            V v;
+            int32_t level, slot;
+
+            timer(uint64_t expiry, V v) : expiry(expiry), v(v), level(0), slot(0) {}
+        };
+
+        linked_node<timer>* wheel[levels][slots];
+        node_pool<linked_node<timer>> pool;
+        uint64_t now;
+        int64_t wheel_size;
+
+        void place(linked_node<timer>* node);
+        void unlink(linked_node<timer>* node);
+        void cascade(int64_t level);
+    public:
+        typedef linked_node<timer>* handle;
+
+        timing_wheel(uint64_t start = 0);
+        timing_wheel(const timing_wheel& copy) = delete;
+
+        ~timing_wheel() { this->clear(); }
+
+        timing_wheel& operator=(const timing_wheel& copy) = delete;
+
+        handle schedule(uint64_t delay, V value);
+        void cancel(handle h);
+
+        template <typename F> int64_t advance(uint64_t ticks, F fn);
+
+        V value(handle h) const;
+        uint64_t expiry(handle h) const;
+        uint64_t time() const;
+
+        void clear();
+
+        int64_t size() const;
+        bool is_empty() const;
+};
+
+template <typename V> void timing_wheel<V>::place(linked_node<timer>* node) {
+    timer& t = node->value_ref();
+    int64_t level = (bit_width(t.expiry ^ this->now) - 1) / slot_bits;
+
+    if (level >= levels) level = levels-1;
+
+    t.level = level;
+    t.slot = (t.expiry >> (slot_bits * level)) & (slots - 1);
+
+    linked_node<timer>* &head = this->wheel[t.level][t.slot];
+
+    node->prev(nullptr, false);
+    node->next(head);
+    head = node;
+}
+
+template <typename V> void timing_wheel<V>::unlink(linked_node<timer>* node) {
+    const timer& t = node->value_ref();
+
+    if (node->prev() == nullptr) {
+        this->wheel[t.level][t.slot] = node->next();
+        if (node->next() != nullptr) node->next()->prev(nullptr, false);
+    } else {
+        node->prev()->next(node->next());
+    }
+}
+
+// Re-places every timer of the level's current slot; each lands in a
+// lower level because it now shares the higher bytes with the clock.
+template <typename V> void timing_wheel<V>::cascade(int64_t level) {
+    int64_t slot = (this->now >> (slot_bits * level)) & (slots - 1);
+
+    linked_node<timer>* node = this->wheel[level][slot];
+    this->wheel[level][slot] = nullptr;
+
+    while (node != nullptr) {
+        linked_node<timer>* next = node->next();
+        this->place(node);
+        node = next;
+    }
+}
+
+template <typename V> timing_wheel<V>::timing_wheel(uint64_t start) : now(start), wheel_size(0) {
+    for (int64_t l = 0; l < levels; l++) {
+        for (int64_t s = 0; s < slots; s++) this->wheel[l][s] = nullptr;
+    }
+}
+
+// The timer fires on the tick `delay` ticks from now; a delay of 0 is
+// treated as 1, since the current tick has already been processed.
+template <typename V>
+typename timing_wheel<V>::handle timing_wheel<V>::schedule(uint64_t delay, V value) {
+    linked_node<timer>* node = this->pool.acquire(timer(this->now + MAX(delay, (uint64_t) 1), value));
+
+    this->place(node);
+    ++this->wheel_size;
+
+    return node;
+}
+
+// A timer whose callback is running is already out of the wheel, marked
+// by a level of -1, and is left for advance() to release.
+template <typename V> void timing_wheel<V>::cancel(handle h) {
+    if (h == nullptr || h->value_ref().level < 0)
+        return;
+
+    this->unlink(h);
+    this->pool.release(h);
+    --this->wheel_size;
+}
+
+// Moves the clock forward tick by tick, calling fn(value) for every timer
+// that expires, and returns how many fired. fn may schedule new timers
+// and cancel pending ones, including others due on the same tick: each
+// timer is unlinked from its slot only as it fires, so the slot stays a
+// valid list throughout, and its node goes back to the pool after fn.
+template <typename V> template <typename F>
+int64_t timing_wheel<V>::advance(uint64_t ticks, F fn) {
+    int64_t fired = 0;
+
+    for (uint64_t k = 0; k < ticks; k++) {
+        ++this->now;
+
+        // Cascade from the highest level whose slot boundary was crossed,
+        // so that its timers can still be cascaded by the levels below.
+        int64_t top = 0;
+
+        while (top+1 < levels && (this->now & ((uint64_t(1) << (slot_bits * (top+1))) - 1)) == 0) {
+            ++top;
+        }
+
+        for (int64_t l = top; l > 0; l--) {
+            this->cascade(l);
+        }
+
+        int64_t slot = this->now & (slots - 1);
+        linked_node<timer>* node;
+
+        // A timer re-placed here lands in a higher level, never back in
+        // this slot, so the loop ends once the slot is empty.
+        while ((node = this->wheel[0][slot]) != nullptr) {
+            this->unlink(node);
+
+            // Timers beyond the top level's range wrap around; keep them.
+            if (node->value_ref().expiry > this->now) {
+                this->place(node);
+                continue;
+            }
+
+            node->value_ref().level = -1;
+            --this->wheel_size;
+            ++fired;
+
+            fn(node->value_ref().v);
+
+            this->pool.release(node);
+        }
+    }
+
+    return fired;
+}
+
+template <typename V> V timing_wheel<V>::value(handle h) const { return h->value_ref().v; }
+
+template <typename V> uint64_t timing_wheel<V>::expiry(handle h) const { return h->value_ref().expiry; }
+
+template <typename V> uint64_t timing_wheel<V>::time() const { return this->now; }
+
+template <typename V> void timing_wheel<V>::clear() {
+    for (int64_t l = 0; l < levels; l++) {
+        for (int64_t s = 0; s < slots; s++) {
+            linked_node<timer>* node = this->wheel[l][s];
+
+            while (node != nullptr) {
+                linked_node<timer>* next = node->next();
+                this->pool.release(node);
+                node = next;
+            }
+
+            this->wheel[l][s] = nullptr;
+        }
+    }
+
+    this->pool.release_all();
+    this->wheel_size = 0;
+}
+
+template <typename V> int64_t timing_wheel<V>::size() const { return this->wheel_size; }
+
+template <typename V> bool timing_wheel<V>::is_empty() const { return (this->wheel_size == 0); }
+
+#endif
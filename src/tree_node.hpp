@@ -49,7 +49,8 @@ template <typename T> class tree_node {
 template <typename T> tree_node<T>::tree_node(T value, 
                                               tree_node<T>* l, 
                                               tree_node<T>* r, 
-                                              int64_t d) : v(value), node_depth(d) {
+                                              int64_t d) : v(value), node_depth(d),
+                                                        parent_node(nullptr) {
     this->left(l, true);
     this->right(r, true);
 }
@@ -0,0 +1,415 @@
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#pragma once
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+#include "pool.hpp"
+#include "vector.hpp"
+
+// Unrolled linked list: a doubly linked list of chunks, each holding up to
+// B elements in a contiguous block. Walks touch one node per B elements,
+// and indexed access skips whole chunks by their counts, starting from
+// whichever end is closer. A full chunk is split in half on insert, and a
+// chunk that drops below a quarter full is merged with its successor.
+template <typename T, int64_t B = 32> class unrolled_list {
+    static_assert(B >= 4, "Chunks need room for at least four elements");
+
+    private:
+        struct chunk {
+            int64_t count;
+            chunk *next, *prev;
+            alignas(T) unsigned char storage[B * sizeof(T)];
+
+            chunk() : count(0), next(nullptr), prev(nullptr) {}
+
+            T& item(int64_t idx) { return reinterpret_cast<T*>(this->storage)[idx]; }
+        };
+
+        int64_t s;
+        chunk *head, *tail;
+        node_pool<chunk> pool;
+
+        chunk* locate(int64_t& idx) const;
+        chunk* split(chunk* c);
+        void unlink(chunk* c);
+        void maybe_merge(chunk* c);
+        void insert_into(chunk* c, int64_t pos, T value);
+        T remove_from(chunk* c, int64_t pos);
+    public:
+        unrolled_list() : s(0), head(nullptr), tail(nullptr), pool(16) {}
+        unrolled_list(const unrolled_list& copy);
+        unrolled_list(unrolled_list&& other);
+
+        ~unrolled_list() { this->clear(); }
+
+        unrolled_list& operator=(unrolled_list copy);
+        void swap(unrolled_list& other);
+
+        void push_front(T value);
+        void push_back(T value);
+
+        void insert(int64_t idx, T value);
+
+        T pop_front();
+        T pop_back();
+        void remove(int64_t idx);
+        void remove(T value);
+        void clear();
+
+        int64_t index(T data) const;
+        int64_t size() const;
+        bool is_empty() const;
+
+        void reverse();
+        void sort();
+
+        T front() const;
+        T back() const;
+
+        template <typename F> void for_each(F fn) const;
+
+        T operator[](int64_t idx) const;
+
+        template <typename U, int64_t C>
+        friend std::ostream& operator<<(std::ostream& out, const unrolled_list<U,C>& l);
+};
+
+// Returns the chunk holding element idx and rewrites idx as the position
+// inside that chunk.
+template <typename T, int64_t B>
+typename unrolled_list<T,B>::chunk* unrolled_list<T,B>::locate(int64_t& idx) const {
+    assert(idx >= 0 && idx < this->s);
+
+    if (idx < this->s/2) {
+        chunk* c = this->head;
+
+        while (idx >= c->count) {
+            idx -= c->count;
+            c = c->next;
+        }
+
+        return c;
+    }
+
+    chunk* c = this->tail;
+    int64_t from_back = this->s - 1 - idx;
+
+    while (from_back >= c->count) {
+        from_back -= c->count;
+        c = c->prev;
+    }
+
+    idx = c->count - 1 - from_back;
+
+    return c;
+}
+
+// Moves the upper half of a full chunk into a new chunk after it.
+template <typename T, int64_t B>
+typename unrolled_list<T,B>::chunk* unrolled_list<T,B>::split(chunk* c) {
+    chunk* n = this->pool.acquire();
+    int64_t half = c->count / 2;
+
+    for (int64_t k = half; k < c->count; k++) {
+        new (&n->item(k - half)) T(std::move(c->item(k)));
+        c->item(k).~T();
+    }
+
+    n->count = c->count - half;
+    c->count = half;
+
+    n->prev = c;
+    n->next = c->next;
+
+    if (c->next != nullptr) c->next->prev = n;
+    else this->tail = n;
+
+    c->next = n;
+
+    return n;
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::unlink(chunk* c) {
+    if (c->prev != nullptr) c->prev->next = c->next;
+    else this->head = c->next;
+
+    if (c->next != nullptr) c->next->prev = c->prev;
+    else this->tail = c->prev;
+
+    this->pool.release(c);
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::maybe_merge(chunk* c) {
+    if (c->count == 0) {
+        this->unlink(c);
+        return;
+    }
+
+    chunk* n = c->next;
+
+    if (c->count >= B/4 || n == nullptr || c->count + n->count > B)
+        return;
+
+    for (int64_t k = 0; k < n->count; k++) {
+        new (&c->item(c->count + k)) T(std::move(n->item(k)));
+        n->item(k).~T();
+    }
+
+    c->count += n->count;
+    n->count = 0;
+
+    this->unlink(n);
+}
+
+template <typename T, int64_t B>
+void unrolled_list<T,B>::insert_into(chunk* c, int64_t pos, T value) {
+    if (c->count == B) {
+        chunk* n = this->split(c);
+
+        if (pos > c->count) {
+            pos -= c->count;
+            c = n;
+        }
+    }
+
+    if (pos == c->count) {
+        new (&c->item(pos)) T(std::move(value));
+    } else {
+        new (&c->item(c->count)) T(std::move(c->item(c->count - 1)));
+
+        for (int64_t k = c->count - 1; k > pos; k--) {
+            c->item(k) = std::move(c->item(k - 1));
+        }
+
+        c->item(pos) = std::move(value);
+    }
+
+    ++c->count;
+    ++this->s;
+}
+
+template <typename T, int64_t B>
+T unrolled_list<T,B>::remove_from(chunk* c, int64_t pos) {
+    T value = std::move(c->item(pos));
+
+    for (int64_t k = pos; k < c->count - 1; k++) {
+        c->item(k) = std::move(c->item(k + 1));
+    }
+
+    c->item(--c->count).~T();
+    --this->s;
+
+    this->maybe_merge(c);
+
+    return value;
+}
+
+template <typename T, int64_t B>
+unrolled_list<T,B>::unrolled_list(const unrolled_list& copy) : unrolled_list() {
+    copy.for_each([this](const T& value) { this->push_back(value); });
+}
+
+template <typename T, int64_t B>
+unrolled_list<T,B>::unrolled_list(unrolled_list&& other) : unrolled_list() {
+    this->swap(other);
+}
+
+template <typename T, int64_t B>
+unrolled_list<T,B>& unrolled_list<T,B>::operator=(unrolled_list copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::swap(unrolled_list& other) {
+    std::swap(this->s, other.s);
+    std::swap(this->head, other.head);
+    std::swap(this->tail, other.tail);
+    this->pool.swap(other.pool);
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::push_front(T value) {
+    if (this->head == nullptr || this->head->count == B) {
+        chunk* c = this->pool.acquire();
+
+        c->next = this->head;
+
+        if (this->head != nullptr) this->head->prev = c;
+        else this->tail = c;
+
+        this->head = c;
+    }
+
+    this->insert_into(this->head, 0, std::move(value));
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::push_back(T value) {
+    if (this->tail == nullptr || this->tail->count == B) {
+        chunk* c = this->pool.acquire();
+
+        c->prev = this->tail;
+
+        if (this->tail != nullptr) this->tail->next = c;
+        else this->head = c;
+
+        this->tail = c;
+    }
+
+    this->insert_into(this->tail, this->tail->count, std::move(value));
+}
+
+// idx == size() appends the value.
+template <typename T, int64_t B> void unrolled_list<T,B>::insert(int64_t idx, T value) {
+    assert(idx >= 0 && idx <= this->s);
+
+    if (idx == this->s) {
+        this->push_back(std::move(value));
+        return;
+    }
+
+    chunk* c = this->locate(idx);
+    this->insert_into(c, idx, std::move(value));
+}
+
+template <typename T, int64_t B> T unrolled_list<T,B>::pop_front() {
+    if (this->is_empty())
+        throw std::out_of_range("The unrolled list is empty");
+
+    return this->remove_from(this->head, 0);
+}
+
+template <typename T, int64_t B> T unrolled_list<T,B>::pop_back() {
+    if (this->is_empty())
+        throw std::out_of_range("The unrolled list is empty");
+
+    return this->remove_from(this->tail, this->tail->count - 1);
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::remove(int64_t idx) {
+    chunk* c = this->locate(idx);
+    this->remove_from(c, idx);
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::remove(T value) {
+    int64_t idx = this->index(value);
+    if (idx == -1) return;
+    else this->remove(idx);
+}
+
+template <typename T, int64_t B> void unrolled_list<T,B>::clear() {
+    for (chunk* c = this->head; c != nullptr; c = c->next) {
+        for (int64_t k = 0; k < c->count; k++) c->item(k).~T();
+    }
+
+    this->pool.release_all();
+    this->head = this->tail = nullptr;
+    this->s = 0;
+}
+
+template <typename T, int64_t B> int64_t unrolled_list<T,B>::index(T data) const {
+    int64_t idx = 0;
+
+    for (chunk* c = this->head; c != nullptr; c = c->next) {
+        for (int64_t k = 0; k < c->count; k++, idx++) {
+            if (c->item(k) == data) return idx;
+        }
+    }
+
+    return -1;
+}
+
+template <typename T, int64_t B> int64_t unrolled_list<T,B>::size() const { return this->s; }
+
+template <typename T, int64_t B> bool unrolled_list<T,B>::is_empty() const { return (this->s == 0); }
+
+template <typename T, int64_t B> void unrolled_list<T,B>::reverse() {
+    chunk* c = this->head;
+
+    while (c != nullptr) {
+        std::reverse(&c->item(0), &c->item(0) + c->count);
+        std::swap(c->next, c->prev);
+        c = c->prev;
+    }
+
+    std::swap(this->head, this->tail);
+}
+
+// Sorts the elements in one contiguous buffer and writes them back, so the
+// chunk structure is left as it was.
+template <typename T, int64_t B> void unrolled_list<T,B>::sort() {
+    vector<T> buffer;
+    buffer.reserve(this->s);
+
+    for (chunk* c = this->head; c != nullptr; c = c->next) {
+        for (int64_t k = 0; k < c->count; k++) buffer.push_back(std::move(c->item(k)));
+    }
+
+    std::stable_sort(buffer.begin(), buffer.end());
+
+    int64_t idx = 0;
+
+    for (chunk* c = this->head; c != nullptr; c = c->next) {
+        for (int64_t k = 0; k < c->count; k++) c->item(k) = std::move(buffer[idx++]);
+    }
+}
+
+template <typename T, int64_t B> T unrolled_list<T,B>::front() const {
+    if (this->is_empty())
+        throw std::out_of_range("The unrolled list is empty");
+
+    return this->head->item(0);
+}
+
+template <typename T, int64_t B> T unrolled_list<T,B>::back() const {
+    if (this->is_empty())
+        throw std::out_of_range("The unrolled list is empty");
+
+    return this->tail->item(this->tail->count - 1);
+}
+
+// Calls fn on every element in order.
+template <typename T, int64_t B> template <typename F>
+void unrolled_list<T,B>::for_each(F fn) const {
+    for (chunk* c = this->head; c != nullptr; c = c->next) {
+        for (int64_t k = 0; k < c->count; k++) fn(c->item(k));
+    }
+}
+
+template <typename T, int64_t B> T unrolled_list<T,B>::operator[](int64_t idx) const {
+    chunk* c = this->locate(idx);
+    return c->item(idx);
+}
+
+template <typename T, int64_t B>
+std::ostream& operator<<(std::ostream& out, const unrolled_list<T,B>& l) {
+    l.for_each([&out](const T& value) { out << "[" << value << "]"; });
+    return out;
+}
+
+template <typename T, int64_t B>
+std::ostream& operator<<(std::ostream& out, const unrolled_list<T,B>* l) {
+    return out << *l;
+}
+
+template <typename T, int64_t B> int64_t binary_search(const unrolled_list<T,B>& l, T value) {
+    int64_t L = 0, R = l.size()-1;
+
+    while (L <= R) {
+        int64_t M = (L+R)/2;
+
+        T s = l[M];
+
+        if (s == value) return M;
+        else if (s > value) R = M - 1;
+        else L = M + 1;
+    }
+
+    return -1;
+}
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#pragma once
+#include <assert.h>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+
+// Contiguous, growable array. Elements live in a single buffer
+// which doubles in capacity when it runs out of room.
+template <typename T> class vector {
+    private:
+        int64_t s, cap;
+        T* buffer;
+
+        void reallocate(int64_t new_capacity);
+    public:
+        vector() : s(0), cap(0), buffer(nullptr) {}
+        vector(int64_t n, T value = T());
+        vector(const vector<T>& copy);
+        vector(vector<T>&& other);
+
+        ~vector();
+
+        vector<T>& operator=(vector<T> copy);
+
+        void push_back(T value);
+        T pop_back();
+
+        void reserve(int64_t new_capacity);
+        void resize(int64_t new_size, T value = T());
+        void clear();
+        void swap(vector<T>& other);
+
+        int64_t size() const;
+        int64_t capacity() const;
+        bool is_empty() const;
+
+        T& front();
+        T& back();
+
+        T* data() const;
+        T* begin() const;
+        T* end() const;
+
+        T& operator[](int64_t idx);
+        const T& operator[](int64_t idx) const;
+
+        template <typename U>
+        friend std::ostream& operator<<(std::ostream& out, const vector<U>& v);
+};
+
+template <typename T> void vector<T>::reallocate(int64_t new_capacity) {
+    T* new_buffer = static_cast<T*>(::operator new(sizeof(T) * new_capacity));
+
+    for (int64_t k = 0; k < this->s; k++) {
+        new (new_buffer + k) T(std::move(this->buffer[k]));
+        this->buffer[k].~T();
+    }
+
+    ::operator delete(this->buffer);
+
+    this->buffer = new_buffer;
+    this->cap = new_capacity;
+}
+
+template <typename T> vector<T>::vector(int64_t n, T value) : s(0), cap(0), buffer(nullptr) {
+    this->resize(n, value);
+}
+
+template <typename T> vector<T>::vector(const vector<T>& copy) : s(0), cap(0), buffer(nullptr) {
+    this->reserve(copy.size());
+
+    for (int64_t k = 0; k < copy.size(); k++) {
+        new (this->buffer + k) T(copy[k]);
+    }
+
+    this->s = copy.size();
+}
+
+template <typename T> vector<T>::vector(vector<T>&& other) : s(other.s), cap(other.cap), buffer(other.buffer) {
+    other.s = other.cap = 0;
+    other.buffer = nullptr;
+}
+
+template <typename T> vector<T>::~vector() {
+    this->clear();
+    ::operator delete(this->buffer);
+}
+
+template <typename T> vector<T>& vector<T>::operator=(vector<T> copy) {
+    this->swap(copy);
+    return *this;
+}
+
+template <typename T> void vector<T>::push_back(T value) {
+    if (this->s == this->cap) {
+        this->reallocate(this->cap == 0 ? 8 : this->cap * 2);
+    }
+
+    new (this->buffer + this->s++) T(std::move(value));
+}
+
+template <typename T> T vector<T>::pop_back() {
+    if (this->is_empty())
+        throw std::out_of_range("The vector is empty");
+
+    T value = std::move(this->buffer[--this->s]);
+    this->buffer[this->s].~T();
+
+    return value;
+}
+
+template <typename T> void vector<T>::reserve(int64_t new_capacity) {
+    if (new_capacity > this->cap)
+        this->reallocate(new_capacity);
+}
+
+template <typename T> void vector<T>::resize(int64_t new_size, T value) {
+    assert(new_size >= 0);
+
+    this->reserve(new_size);
+
+    while (this->s > new_size) {
+        this->buffer[--this->s].~T();
+    }
+
+    while (this->s < new_size) {
+        new (this->buffer + this->s++) T(value);
+    }
+}
+
+template <typename T> void vector<T>::clear() {
+    while (this->s > 0) {
+        this->buffer[--this->s].~T();
+    }
+}
+
+template <typename T> void vector<T>::swap(vector<T>& other) {
+    std::swap(this->s, other.s);
+    std::swap(this->cap, other.cap);
+    std::swap(this->buffer, other.buffer);
+}
+
+template <typename T> int64_t vector<T>::size() const { return this->s; }
+
+template <typename T> int64_t vector<T>::capacity() const { return this->cap; }
+
+template <typename T> bool vector<T>::is_empty() const { return (this->s == 0); }
+
+template <typename T> T& vector<T>::front() {
+    assert(this->s > 0);
+    return this->buffer[0];
+}
+
+template <typename T> T& vector<T>::back() {
+    assert(this->s > 0);
+    return this->buffer[this->s-1];
+}
+
+template <typename T> T* vector<T>::data() const { return this->buffer; }
+
+template <typename T> T* vector<T>::begin() const { return this->buffer; }
+
+template <typename T> T* vector<T>::end() const { return this->buffer + this->s; }
+
+template <typename T> T& vector<T>::operator[](int64_t idx) {
+    assert(idx >= 0 && idx < this->s);
+    return this->buffer[idx];
+}
+
+template <typename T> const T& vector<T>::operator[](int64_t idx) const {
+    assert(idx >= 0 && idx < this->s);
+    return this->buffer[idx];
+}
+
+template <typename T> std::ostream& operator<<(std::ostream& out, const vector<T>& v) {
+    for (int64_t k = 0; k < v.size(); k++) {
+        out << "[" << v[k] << "]";
+    }
+
+    return out;
+}
+
+template <typename T> std::ostream& operator<<(std::ostream& out, const vector<T>* v) {
+    return out << *v;
+}
+
+#endif
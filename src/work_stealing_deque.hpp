@@ -0,0 +1,166 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <stdint.h>
+#include <type_traits>
+#include "vector.hpp"
+
+// Chase-Lev work-stealing deque. One owner thread pushes and pops at the
+// bottom like a stack, while any number of thieves steal from the top,
+// so the owner works on its newest items and thieves take the oldest,
+// which in fork-join code are the largest pieces of work. Only the last
+// item is contended: the owner and the thieves race for it with a CAS on
+// top, and every other operation is a plain load and store.
+//
+// The circular array doubles when full. A thief may still be reading an
+// old array, so replaced arrays are kept until the deque is destroyed;
+// they add up to less than the current one. Items are stored in atomics
+// and must be trivially copyable, such as task pointers.
+template <typename T> class work_stealing_deque {
+    static_assert(std::is_trivially_copyable<T>::value, "Items must be trivially copyable");
+
+    private:
+        struct ring {
+            int64_t cap;
+            std::atomic<T>* items;
+
+            ring(int64_t cap) : cap(cap), items(new std::atomic<T>[cap]) {}
+            ~ring() { delete[] this->items; }
+
+            T get(int64_t idx) const { return this->items[idx & (this->cap - 1)].load(std::memory_order_relaxed); }
+            void put(int64_t idx, T value) { this->items[idx & (this->cap - 1)].store(value, std::memory_order_relaxed); }
+        };
+
+        alignas(64) std::atomic<int64_t> top;
+        alignas(64) std::atomic<int64_t> bottom;
+        std::atomic<ring*> array;
+        vector<ring*> retired;
+
+        ring* grow(ring* a, int64_t b, int64_t t);
+    public:
+        work_stealing_deque(int64_t capacity = 256);
+        work_stealing_deque(const work_stealing_deque& copy) = delete;
+
+        ~work_stealing_deque();
+
+        work_stealing_deque& operator=(const work_stealing_deque& copy) = delete;
+
+        void push(T value);
+        bool pop(T& value);
+        bool steal(T& value);
+
+        int64_t size() const;
+        bool is_empty() const;
+};
+
+template <typename T>
+typename work_stealing_deque<T>::ring* work_stealing_deque<T>::grow(ring* a, int64_t b, int64_t t) {
+    ring* bigger = new ring(2 * a->cap);
+
+    for (int64_t k = t; k < b; k++) bigger->put(k, a->get(k));
+
+    this->retired.push_back(a);
+    this->array.store(bigger, std::memory_order_release);
+
+    return bigger;
+}
+
+template <typename T> work_stealing_deque<T>::work_stealing_deque(int64_t capacity) : top(0), bottom(0) {
+    int64_t cap = 2;
+
+    while (cap < capacity) cap *= 2;
+
+    this->array.store(new ring(cap), std::memory_order_relaxed);
+}
+
+template <typename T> work_stealing_deque<T>::~work_stealing_deque() {
+    delete this->array.load(std::memory_order_relaxed);
+
+    for (int64_t k = 0; k < this->retired.size(); k++) delete this->retired[k];
+}
+
+// Owner only.
+template <typename T> void work_stealing_deque<T>::push(T value) {
+    int64_t b = this->bottom.load(std::memory_order_relaxed),
+            t = this->top.load(std::memory_order_acquire);
+    ring* a = this->array.load(std::memory_order_relaxed);
+
+    if (b - t > a->cap - 1) a = this->grow(a, b, t);
+
+    a->put(b, value);
+
+    std::atomic_thread_fence(std::memory_order_release);
+    this->bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+// Owner only. Takes the newest item.
+template <typename T> bool work_stealing_deque<T>::pop(T& value) {
+    int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+    ring* a = this->array.load(std::memory_order_relaxed);
+
+    // Claim the bottom slot before looking at top, so that a thief either
+    // sees the claim or the owner sees the thief's CAS.
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    int64_t t = this->top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    value = a->get(b);
+
+    if (t == b) {
+        // Last item: race the thieves for it.
+        bool won = this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+
+        return won;
+    }
+
+    return true;
+}
+
+// Any thread. Takes the oldest item; fails when the deque is empty or
+// another thread took the item first.
+template <typename T> bool work_stealing_deque<T>::steal(T& value) {
+    int64_t t = this->top.load(std::memory_order_acquire);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    int64_t b = this->bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+        return false;
+
+    ring* a = this->array.load(std::memory_order_acquire);
+    T item = a->get(t);
+
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+        return false;
+    }
+
+    value = item;
+
+    return true;
+}
+
+// Approximate when called while thieves are active.
+template <typename T> int64_t work_stealing_deque<T>::size() const {
+    int64_t b = this->bottom.load(std::memory_order_relaxed),
+            t = this->top.load(std::memory_order_relaxed);
+
+    return (b > t ? b - t : 0);
+}
+
+template <typename T> bool work_stealing_deque<T>::is_empty() const { return (this->size() == 0); }
+
+#endif